@@ -0,0 +1,250 @@
+/*************************************************************************
+* Title: Concurrent Tree Benchmark
+* File: bench_concurrent.cpp
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Read-mostly benchmark of myTree::ConcurrentTree (path copying, epoch
+* reclaimed snapshots) against a Tree<Block, AVL> behind a reader/writer
+* lock, for 1 to 64 threads. Both trees start with INITIAL_BLOCKS blocks.
+* Each operation is, at random, a find of one of those blocks (read percent
+* of operations) or an add of a new block. Every find must succeed, and the
+* final size must count every add.
+*
+* Then checks snapshots hold their version: a reader takes a snapshot and
+* traverses it over and over while writer threads add SNAPSHOT_BLOCKS
+* blocks, many times RECLAIM_THRESHOLD nodes. Its size and in-order blocks
+* must never change, and no node replaced after it was taken may be freed
+* until it is released. Once it is, the next inserts must free them.
+*
+* Usage: bench_concurrent [operations] [read percent]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 -pthread bench_concurrent.cpp block.cpp hash_simd.cpp
+*  (2) Each thread draws its own finds and adds (seeded per thread), so both
+*      trees see the same operations for a given thread count.
+*  (3) Adds are serialized in both trees, only finds can run in parallel.
+*      Concurrent finds never wait on an add, locked finds wait for it, so
+*      the gap depends on the add percent as much as on the core count.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Added snapshot stability check. JME
+*************************************************************************/
+#include <atomic>       // counts
+#include <chrono>       // timing
+#include <cstdlib>      // strtoul
+#include <iomanip>      // manipulators
+#include <iostream>     // cout
+#include <mutex>        // locks
+#include <random>       // mt19937
+#include <shared_mutex> // reader/writer lock
+#include <thread>       // threads
+#include <utility>      // pair
+#include <vector>       // threads, blocks
+
+#include "block.h"
+#include "concurrent_tree.h"
+#include "tree.h"
+
+using namespace myBlock;
+using namespace myTree;
+
+// Default number of operations.
+constexpr unsigned long DEFAULT_OPERATIONS = 2000000;
+// Default percent of operations which are finds.
+constexpr unsigned long DEFAULT_READ_PERCENT = 90;
+// Blocks in tree before timing.
+constexpr unsigned long INITIAL_BLOCKS = 100000;
+// Thread counts.
+constexpr unsigned int THREADS[] = { 1, 2, 4, 8, 16, 32, 64 };
+// Fixed seed for nonces.
+constexpr unsigned int SEED = 269;
+// Blocks added while a snapshot is held, and threads adding them.
+constexpr unsigned long SNAPSHOT_BLOCKS = 50 * RECLAIM_THRESHOLD;
+constexpr unsigned int SNAPSHOT_WRITERS = 4;
+
+// Tree guarded by a reader/writer lock.
+class LockedTree
+{
+	mutable std::shared_mutex lock;
+	Tree<Block, AVL> tree;
+
+public:
+	void add(const Block& b)
+	{
+		std::unique_lock<std::shared_mutex> guard(lock);
+		tree.add(b);
+	}
+
+	bool find(const Block& b) const
+	{
+		std::shared_lock<std::shared_mutex> guard(lock);
+		return tree.find(b);
+	}
+
+	std::size_t size() const
+	{
+		std::shared_lock<std::shared_mutex> guard(lock);
+		return tree.size();
+	}
+};
+
+// Operations/s of a find/add mix on tree filled with initial blocks, split
+// over threads. Returns 0 if a find missed or an add was lost.
+template <class TreeType>
+static double mixedRate(unsigned int threads, unsigned long operations, unsigned long readPercent, const std::vector<Block>& initial)
+{
+	TreeType tree;
+	std::atomic<unsigned long> reads(0), found(0), writes(0);
+	const unsigned long perThread = operations / threads;
+
+	for (auto& b : initial)
+		tree.add(b);
+
+	auto worker = [&](unsigned int t)
+	{
+		std::mt19937 mt(SEED + 1 + t);
+		unsigned long r = 0, f = 0, w = 0;
+		Block probe;
+
+		for (unsigned long i = 0; i < perThread; i++)
+		{
+			if (mt() % 100 < readPercent)
+			{
+				f += tree.find(initial[mt() % initial.size()]);
+				r++;
+			}
+			else
+			{
+				probe.setID(INITIAL_BLOCKS + t * perThread + i);
+				probe.setNonce(mt());
+				tree.add(probe);
+				w++;
+			}
+		}
+		reads += r;
+		found += f;
+		writes += w;
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (unsigned int t = 0; t < threads; t++)
+		pool.emplace_back(worker, t);
+	for (auto& t : pool)
+		t.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	bool ok = found == reads && tree.size() == initial.size() + writes;
+	return ok ? threads * perThread / elapsed.count() : 0;
+}
+
+// Hold a snapshot while writers add SNAPSHOT_BLOCKS blocks, traversing it
+// until they finish. Returns false if the snapshot changed, a node it could
+// reach was freed, or replaced nodes weren't freed after it was released.
+static bool snapshotStable(const std::vector<Block>& initial)
+{
+	typedef std::pair<unsigned long, unsigned long> Key; // Id, nonce.
+
+	ConcurrentTree<Block> tree;
+	std::vector<Key> expected, seen;
+	std::atomic<bool> writing(true);
+	unsigned long traversals = 0;
+	bool stable = true;
+	std::size_t kept, freed;
+
+	for (auto& b : initial)
+		tree.add(b);
+
+	{
+		auto snapshot = tree.snapshot();
+		// Only nodes replaced before the snapshot may be freed while it lives.
+		const std::size_t retiredBefore = tree.retiredNodes(), freedBefore = tree.reclaimedNodes();
+
+		expected.reserve(snapshot.size());
+		for (const Block& b : snapshot)
+			expected.emplace_back(b.getID(), b.getNonce());
+
+		std::vector<std::thread> writers;
+		for (unsigned int t = 0; t < SNAPSHOT_WRITERS; t++)
+			writers.emplace_back([&, t]()
+			{
+				std::mt19937 mt(SEED + 100 + t);
+				const unsigned long perThread = SNAPSHOT_BLOCKS / SNAPSHOT_WRITERS;
+
+				for (unsigned long i = 0; i < perThread; i++)
+					tree.add(Block(INITIAL_BLOCKS + t * perThread + i, "0", mt()));
+			});
+		std::thread done([&]()
+		{
+			for (auto& t : writers)
+				t.join();
+			writing = false;
+		});
+
+		// Traverse at least once after the last add.
+		for (bool last = false; stable && !last; traversals++)
+		{
+			last = !writing.load();
+			seen.clear();
+			for (const Block& b : snapshot)
+				seen.emplace_back(b.getID(), b.getNonce());
+			stable = snapshot.size() == initial.size() && seen == expected;
+		}
+		done.join();
+
+		kept = tree.retiredNodes();
+		freed = tree.reclaimedNodes();
+		stable = stable && freed - freedBefore <= retiredBefore && kept >= SNAPSHOT_BLOCKS
+			&& tree.size() == initial.size() + SNAPSHOT_BLOCKS;
+	}
+
+	// Released, the next reclaim frees everything retired.
+	for (unsigned long i = 0; i < RECLAIM_THRESHOLD; i++)
+		tree.add(Block(INITIAL_BLOCKS + SNAPSHOT_BLOCKS + i, "0", i));
+	const bool released = tree.retiredNodes() < RECLAIM_THRESHOLD && tree.reclaimedNodes() >= freed + kept;
+
+	std::cout << "Snapshot of " << initial.size() << " blocks held while " << SNAPSHOT_WRITERS << " threads added " << SNAPSHOT_BLOCKS
+		<< " blocks (" << traversals << " traversals): " << (stable ? "unchanged" : "CHANGED") << ", " << kept
+		<< " replaced nodes kept, " << (released ? "freed after release" : "NOT FREED after release") << "\n";
+	return stable && released;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long operations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : DEFAULT_OPERATIONS;
+	unsigned long readPercent = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : DEFAULT_READ_PERCENT;
+	std::mt19937 mt(SEED);
+	std::vector<Block> initial;
+
+	initial.reserve(INITIAL_BLOCKS);
+	for (unsigned long i = 0; i < INITIAL_BLOCKS; i++)
+		initial.emplace_back(i, "0", mt());
+
+	std::cout << operations << " operations (" << readPercent << "% finds, " << 100 - readPercent << "% adds) on " << INITIAL_BLOCKS
+		<< " block tree (operations/s), " << std::thread::hardware_concurrency() << " hardware threads:\n"
+		<< "threads  rw-locked    concurrent speedup\n";
+
+	for (unsigned int threads : THREADS)
+	{
+		double locked = mixedRate<LockedTree>(threads, operations, readPercent, initial);
+		double concurrent = mixedRate<ConcurrentTree<Block>>(threads, operations, readPercent, initial);
+
+		if (locked == 0 || concurrent == 0)
+		{
+			std::cout << "Missed find or lost add at " << threads << " threads\n";
+			return EXIT_FAILURE;
+		}
+
+		std::cout << std::setw(7) << threads << std::fixed << std::setprecision(0) << std::setw(11) << locked
+			<< std::setw(14) << concurrent << std::setw(7) << std::setprecision(2) << concurrent / locked << "x\n";
+	}
+
+	std::cout << "\n";
+	if (!snapshotStable(initial))
+		return EXIT_FAILURE;
+
+	return 0;
+}
@@ -0,0 +1,383 @@
+/*************************************************************************
+* Title: Container Benchmark
+* File: bench_containers.cpp
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Benchmarks the custom containers against their standard library
+* counterparts, for several sizes and key orders:
+*
+*   Tree<T> (unbalanced, AVL)  vs std::set   insert, find, in-order and
+*                                             bfs traversal, balance, remove.
+*   Queue<T, GROWABLE>         vs std::deque  enqueue, dequeue.
+*   Vector<T>                  vs std::vector push_back, iterate.
+*
+* Key orders:
+*   random       shuffled keys.
+*   sorted       increasing keys, degenerates an unbalanced tree to a list.
+*   adversarial  alternating smallest/largest remaining key (zig-zag),
+*                also degenerate, and forces AVL rotations on every insert.
+*
+* Reports nanoseconds per operation, and cache and branch misses per
+* operation where hardware counters are available (Linux perf_event_open).
+*
+* Usage: bench_containers [--sizes 1000,10000,100000,1000000] [--seed 269]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 bench_containers.cpp
+*  (2) Sizes below MIN_OPS elements are repeated until MIN_OPS operations
+*      are timed.
+*  (3) The unbalanced tree is only run on sorted and adversarial keys up
+*      to DEGENERATE_LIMIT elements, since every operation is O(n) there.
+*  (4) Counters need perf_event_paranoid <= 2 (or CAP_PERFMON), and are
+*      usually unavailable inside virtual machines and containers.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*************************************************************************/
+#include <algorithm> // shuffle
+#include <chrono>    // timing
+#include <cstdint>   // uint64_t
+#include <cstdlib>   // strtoul
+#include <cstring>   // strcmp
+#include <deque>     // std::deque
+#include <iomanip>   // manipulators
+#include <iostream>  // cout
+#include <random>    // mt19937
+#include <set>       // std::set
+#include <sstream>   // list parsing
+#include <string>    // strings
+#include <vector>    // std::vector
+
+#if defined(__linux__)
+#include <linux/perf_event.h> // perf_event_attr
+#include <sys/ioctl.h>        // counter control
+#include <sys/syscall.h>      // perf_event_open
+#include <unistd.h>           // read, close
+#endif
+
+// Include tree balancing code.
+#define BALANCE_TREE
+
+#include "queue.h"
+#include "tree.h"
+#include "vector.h"
+
+using namespace myQueue;
+using namespace myTree;
+using namespace myVector;
+
+typedef uint64_t Key;
+
+// Default benchmark parameters.
+constexpr unsigned int DEFAULT_SEED = 269;
+const std::vector<unsigned long> DEFAULT_SIZES = { 1000, 10000, 100000, 1000000 };
+// Minimum operations timed per size.
+constexpr unsigned long MIN_OPS = 1000000;
+// Largest unbalanced tree built from sorted or adversarial keys.
+constexpr unsigned long DEGENERATE_LIMIT = 20000;
+
+enum class Order { Random, Sorted, Adversarial };
+const char* ORDER_NAMES[] = { "random", "sorted", "adversarial" };
+
+// Hardware cache and branch miss counters for this thread.
+class PerfCounters
+{
+	int cacheFd;  // Cache miss counter (group leader).
+	int branchFd; // Branch miss counter.
+
+#if defined(__linux__)
+	static int open(uint64_t config, int group)
+	{
+		perf_event_attr attr;
+
+		std::memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = config;
+		attr.disabled = group == -1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, 0));
+	}
+#endif
+
+public:
+	PerfCounters() : cacheFd(-1), branchFd(-1)
+	{
+#if defined(__linux__)
+		cacheFd = open(PERF_COUNT_HW_CACHE_MISSES, -1);
+		if (cacheFd >= 0)
+			branchFd = open(PERF_COUNT_HW_BRANCH_MISSES, cacheFd);
+		if (branchFd < 0 && cacheFd >= 0)
+		{
+			close(cacheFd);
+			cacheFd = -1;
+		}
+#endif
+	}
+	~PerfCounters()
+	{
+#if defined(__linux__)
+		if (cacheFd >= 0)
+		{
+			close(branchFd);
+			close(cacheFd);
+		}
+#endif
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator= (const PerfCounters&) = delete;
+
+	bool available() const { return cacheFd >= 0; }
+
+	void start()
+	{
+#if defined(__linux__)
+		if (available())
+		{
+			ioctl(cacheFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(cacheFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+#endif
+	}
+
+	// Stop counting, adds counts since start().
+	void stop(uint64_t& cacheMisses, uint64_t& branchMisses)
+	{
+#if defined(__linux__)
+		if (available())
+		{
+			uint64_t values[3] = { 0, 0, 0 }; // Count, cache misses, branch misses.
+
+			ioctl(cacheFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+			if (read(cacheFd, values, sizeof(values)) == sizeof(values))
+			{
+				cacheMisses += values[1];
+				branchMisses += values[2];
+			}
+		}
+#else
+		(void)cacheMisses;
+		(void)branchMisses;
+#endif
+	}
+};
+
+static PerfCounters counters;
+
+// Totals for one operation.
+struct OpStats
+{
+	double seconds = 0;
+	uint64_t ops = 0;
+	uint64_t cacheMisses = 0;
+	uint64_t branchMisses = 0;
+};
+
+// Time f, which performs ops operations.
+template <class Func>
+static void measure(OpStats& stats, uint64_t ops, Func f)
+{
+	counters.start();
+	auto start = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	counters.stop(stats.cacheMisses, stats.branchMisses);
+
+	stats.seconds += elapsed.count();
+	stats.ops += ops;
+}
+
+// Print one result row.
+static void report(const char* container, Order order, unsigned long n, const char* op, const OpStats& s)
+{
+	std::cout << std::setw(10) << container << std::setw(12) << ORDER_NAMES[static_cast<int>(order)]
+		<< std::setw(9) << n << std::setw(10) << op << std::fixed << std::setprecision(1)
+		<< std::setw(10) << s.seconds * 1e9 / s.ops;
+	if (counters.available())
+		std::cout << std::setprecision(2) << std::setw(12) << static_cast<double>(s.cacheMisses) / s.ops
+			<< std::setw(12) << static_cast<double>(s.branchMisses) / s.ops;
+	std::cout << "\n";
+}
+
+// Keys 0 to n-1 in requested order.
+static std::vector<Key> makeKeys(unsigned long n, Order order, std::mt19937_64& mt)
+{
+	std::vector<Key> keys(n);
+
+	for (unsigned long i = 0; i < n; i++)
+		keys[i] = i;
+
+	if (order == Order::Random)
+		std::shuffle(keys.begin(), keys.end(), mt);
+	else if (order == Order::Adversarial)
+		for (unsigned long i = 0; i < n; i++)
+			keys[i] = (i & 1) ? n - 1 - i / 2 : i / 2;
+
+	return keys;
+}
+
+// Tree (and std::set) operations. Lookups are random present keys.
+template <class TreeType>
+static void benchTree(const char* name, Order order, const std::vector<Key>& keys, const std::vector<Key>& lookups, unsigned long reps)
+{
+	OpStats insert, find, inOrder, bfs, balance, remove;
+	std::size_t found = 0;
+	Key sum = 0;
+
+	for (unsigned long r = 0; r < reps; r++)
+	{
+		TreeType tree;
+
+		measure(insert, keys.size(), [&]() { for (Key k : keys) tree.add(k); });
+		measure(find, lookups.size(), [&]() { for (Key k : lookups) found += tree.find(k); });
+		measure(inOrder, keys.size(), [&]() { tree.inOrder([&](Key k) { sum += k; }); });
+		measure(bfs, keys.size(), [&]() { tree.bfs([&](Key k) { sum += k; }); });
+		measure(balance, keys.size(), [&]() { tree.balance(); });
+		measure(remove, keys.size(), [&]() { for (Key k : keys) tree.remove(k); });
+	}
+
+	report(name, order, keys.size(), "insert", insert);
+	report(name, order, keys.size(), "find", find);
+	report(name, order, keys.size(), "inOrder", inOrder);
+	report(name, order, keys.size(), "bfs", bfs);
+	report(name, order, keys.size(), "balance", balance);
+	report(name, order, keys.size(), "remove", remove);
+	if (found != lookups.size() * reps || sum == 0)
+		std::cout << "  (" << name << " lookup failed)\n";
+}
+
+static void benchSet(Order order, const std::vector<Key>& keys, const std::vector<Key>& lookups, unsigned long reps)
+{
+	OpStats insert, find, inOrder, remove;
+	std::size_t found = 0;
+	Key sum = 0;
+
+	for (unsigned long r = 0; r < reps; r++)
+	{
+		std::set<Key> set;
+
+		measure(insert, keys.size(), [&]() { for (Key k : keys) set.insert(k); });
+		measure(find, lookups.size(), [&]() { for (Key k : lookups) found += set.count(k); });
+		measure(inOrder, keys.size(), [&]() { for (Key k : set) sum += k; });
+		measure(remove, keys.size(), [&]() { for (Key k : keys) set.erase(k); });
+	}
+
+	report("std::set", order, keys.size(), "insert", insert);
+	report("std::set", order, keys.size(), "find", find);
+	report("std::set", order, keys.size(), "inOrder", inOrder);
+	report("std::set", order, keys.size(), "remove", remove);
+	if (found != lookups.size() * reps || sum == 0)
+		std::cout << "  (std::set lookup failed)\n";
+}
+
+// Queue and std::deque, enqueue all keys then dequeue all.
+static void benchQueues(const std::vector<Key>& keys, unsigned long reps)
+{
+	OpStats qPush, qPop, dPush, dPop;
+	Key qSum = 0, dSum = 0;
+
+	for (unsigned long r = 0; r < reps; r++)
+	{
+		Queue<Key, GROWABLE> q;
+		std::deque<Key> d;
+
+		measure(qPush, keys.size(), [&]() { for (Key k : keys) q.enqueue(k); });
+		measure(qPop, keys.size(), [&]() { while (!q.empty()) { qSum += q.front(); q.dequeue(); } });
+		measure(dPush, keys.size(), [&]() { for (Key k : keys) d.push_back(k); });
+		measure(dPop, keys.size(), [&]() { while (!d.empty()) { dSum += d.front(); d.pop_front(); } });
+	}
+
+	report("Queue", Order::Random, keys.size(), "enqueue", qPush);
+	report("Queue", Order::Random, keys.size(), "dequeue", qPop);
+	report("deque", Order::Random, keys.size(), "enqueue", dPush);
+	report("deque", Order::Random, keys.size(), "dequeue", dPop);
+	if (qSum != dSum)
+		std::cout << "  (queue sum mismatch)\n";
+}
+
+// Vector and std::vector, push_back all keys then iterate.
+static void benchVectors(const std::vector<Key>& keys, unsigned long reps)
+{
+	OpStats vPush, vIter, sPush, sIter;
+	Key vSum = 0, sSum = 0;
+
+	for (unsigned long r = 0; r < reps; r++)
+	{
+		Vector<Key> v;
+		std::vector<Key> s;
+
+		measure(vPush, keys.size(), [&]() { for (Key k : keys) v.push_back(k); });
+		measure(vIter, keys.size(), [&]() { for (Key k : v) vSum += k; });
+		measure(sPush, keys.size(), [&]() { for (Key k : keys) s.push_back(k); });
+		measure(sIter, keys.size(), [&]() { for (Key k : s) sSum += k; });
+	}
+
+	report("Vector", Order::Random, keys.size(), "push_back", vPush);
+	report("Vector", Order::Random, keys.size(), "iterate", vIter);
+	report("vector", Order::Random, keys.size(), "push_back", sPush);
+	report("vector", Order::Random, keys.size(), "iterate", sIter);
+	if (vSum != sSum)
+		std::cout << "  (vector sum mismatch)\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<unsigned long> sizes = DEFAULT_SIZES;
+	unsigned int seed = DEFAULT_SEED;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (!std::strcmp(argv[i], "--sizes"))
+		{
+			std::stringstream ss(argv[i + 1]);
+			std::string item;
+
+			sizes.clear();
+			while (std::getline(ss, item, ','))
+				if (unsigned long n = std::strtoul(item.c_str(), nullptr, 10))
+					sizes.push_back(n);
+		}
+		else if (!std::strcmp(argv[i], "--seed"))
+			seed = std::strtoul(argv[i + 1], nullptr, 10);
+		else
+		{
+			std::cout << "Unknown option " << argv[i] << "\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::cout << "Container benchmark, seed " << seed << ", nanoseconds per operation"
+		<< (counters.available() ? ", cache/branch misses per operation" : " (hardware counters unavailable)") << ":\n"
+		<< " container       order        n        op     ns/op" << (counters.available() ? "  cache-miss branch-miss" : "") << "\n";
+
+	std::mt19937_64 mt(seed);
+	for (unsigned long n : sizes)
+	{
+		unsigned long reps = std::max(1ul, MIN_OPS / n);
+		std::vector<Key> lookups(n);
+
+		for (auto& k : lookups)
+			k = mt() % n;
+
+		for (Order order : { Order::Random, Order::Sorted, Order::Adversarial })
+		{
+			std::vector<Key> keys = makeKeys(n, order, mt);
+
+			if (order == Order::Random || n <= DEGENERATE_LIMIT)
+				benchTree<Tree<Key>>("Tree", order, keys, lookups, reps);
+			benchTree<Tree<Key, AVL>>("Tree AVL", order, keys, lookups, reps);
+			benchSet(order, keys, lookups, reps);
+		}
+
+		std::vector<Key> keys = makeKeys(n, Order::Random, mt);
+		benchQueues(keys, reps);
+		benchVectors(keys, reps);
+	}
+
+	return 0;
+}
@@ -0,0 +1,679 @@
+/*************************************************************************
+* Title: Hashing Benchmark
+* File: bench_hash.cpp
+* Author: James Eli
+* Date: 10/16/2026
+*
+* Microbenchmark of the block mining hash loop. Mines the same chain with
+* the original string/stringstream mining loop and with Block::MineBlock,
+* checks both find the same nonces and hashes, and reports hashes per
+* second for each. Then compares hashing whole "prevHash" + "nonce" 
+* messages against reusing the previous hash midstate, for each hash 
+* function and several previous hash lengths. Finally cross-checks the
+* multi-lane (SIMD) FNV-1a and SDBM kernels against the scalar functions,
+* for every instruction set the CPU supports, and times them. Last, the
+* CRC-32 variants (bitwise, slicing-by-4/8, PCLMULQDQ) are checked against
+* each other and timed over several message lengths. FNV-1a 64 and XXH64
+* are checked against reference digests, and streamed against one-shot
+* hashing. SHA-256 is checked against the FIPS 180-4 test vectors, and
+* each SHA-256 mining kernel is cross-checked and timed. Then validates a
+* chain of VALIDATE_BLOCKS compact blocks with increasing thread counts,
+* and checks corrupted blocks are reported.
+*
+* Usage: bench_hash [difficulty] [blocks]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 -pthread bench_hash.cpp block.cpp hash_simd.cpp chain_file.cpp
+*
+*************************************************************************
+* Change Log:
+*   10/16/2026: Initial release. JME
+*   10/16/2026: Added midstate benchmark. JME
+*   10/16/2026: Added multi-lane kernel cross-check and benchmark. JME
+*   10/16/2026: Added CRC-32 variants benchmark. JME
+*   10/17/2026: Added chain validation benchmark. JME
+*   10/17/2026: Added SHA-256 test vectors and kernel benchmark. JME
+*   10/17/2026: Added FNV-1a 64 and XXH64 reference digests. JME
+*************************************************************************/
+#include <algorithm> // min
+#include <charconv>  // to_chars
+#include <chrono>    // timing
+#include <cstdlib>   // strtoul
+#include <iomanip>   // hex manipulators
+#include <iostream>  // cout
+#include <random>    // mt19937
+#include <sstream>   // stringstream
+#include <string>    // strings
+#include <vector>    // results
+
+#include "block.h"
+#include "chain_validate.h"
+#include "compact_block.h"
+#include "hash_funcs.h"
+#include "hash_simd.h"
+#include "hashers.h"
+
+using namespace myBlock;
+using namespace myChain;
+
+// Default benchmark parameters.
+constexpr unsigned int DEFAULT_DIFFICULTY = 4;
+constexpr unsigned long DEFAULT_BLOCKS = 200;
+// Nonces hashed per midstate benchmark.
+constexpr unsigned long MIDSTATE_NONCES = 2000000;
+// Previous hash lengths for midstate benchmark.
+constexpr std::size_t PREFIX_LENGTHS[] = { 10, 64, 256, 1024 };
+// Nonces (and random messages) cross-checked per multi-lane kernel.
+constexpr unsigned long CROSS_CHECK_INPUTS = 4000000;
+// Nonces hashed per multi-lane benchmark.
+constexpr unsigned long LANE_NONCES = 40000000;
+// Nonces hashed per SHA-256 kernel benchmark.
+constexpr unsigned long SHA256_NONCES = 2000000;
+// Fixed seed for random cross-check messages.
+constexpr unsigned int SEED = 269;
+// Bytes hashed per CRC-32 variant and message length.
+constexpr std::size_t CRC_BYTES = 32 * 1024 * 1024;
+// Message lengths for CRC-32 benchmark.
+constexpr std::size_t CRC_LENGTHS[] = { 16, 64, 256, 1024, 4096, 65536 };
+// Blocks in validated chain.
+constexpr std::size_t VALIDATE_BLOCKS = 2000000;
+
+// Result of mining one block.
+struct MineResult
+{
+	unsigned long nonce;
+	std::string hash;
+};
+
+// Original mining loop: string concatenation and hex text comparison.
+static MineResult legacyMine(const std::string& previousHash, unsigned int difficulty)
+{
+	Hash<> fnv1a;
+	std::string sDifficulty(difficulty, '0');
+	std::stringstream hexHash;
+	unsigned long nonce = 0;
+	uint32_t h = 0;
+
+	for (; hexHash.str().substr(0, difficulty) != sDifficulty; nonce++)
+	{
+		h = fnv1a.hashString(previousHash + std::to_string(nonce));
+		hexHash.str("");
+		hexHash << std::hex << std::setfill('0') << std::setw(8) << h;
+	}
+
+	return { nonce - 1, std::to_string(h) };
+}
+
+// Mine a chain and return results, total attempts and elapsed seconds.
+template <class Miner>
+static double mineChain(Miner miner, unsigned long blocks, std::vector<MineResult>& results, unsigned long long& attempts)
+{
+	std::string hash("0");
+
+	results.clear();
+	attempts = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long i = 0; i < blocks; i++)
+	{
+		results.push_back(miner(i, hash));
+		attempts += results.back().nonce + 1;
+		hash = results.back().hash;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count();
+}
+
+static void report(const char* name, unsigned long long attempts, double seconds)
+{
+	std::cout << std::setw(12) << name << ": " << std::setw(12) << attempts << " hashes "
+		<< std::fixed << std::setprecision(3) << std::setw(8) << seconds << " s "
+		<< std::setprecision(0) << std::setw(14) << attempts / seconds << " hashes/s\n";
+}
+
+// Hash nonces after a prefix of given length, first whole message then using
+// the prefix midstate. Returns false if results differ.
+template <HashFunc hf>
+static bool midstate(const char* name, std::size_t prefixLength)
+{
+	Hash<hf> h;
+	std::string message(prefixLength, '7');
+	uint32_t sumFull = 0, sumMid = 0;
+
+	message.resize(prefixLength + 20);
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long n = 0; n < MIDSTATE_NONCES; n++)
+	{
+		char *end = std::to_chars(&message[prefixLength], &message[0] + message.size(), n).ptr;
+		sumFull += h.hashBytes(message.data(), end - message.data());
+	}
+	std::chrono::duration<double> tFull = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	typename Hash<hf>::State prefix = h.init();
+	h.update(prefix, message.data(), prefixLength);
+	for (unsigned long n = 0; n < MIDSTATE_NONCES; n++)
+	{
+		char digits[20];
+		char *end = std::to_chars(digits, digits + sizeof(digits), n).ptr;
+		typename Hash<hf>::State state(prefix);
+		h.update(state, digits, end - digits);
+		sumMid += h.finalize(state);
+	}
+	std::chrono::duration<double> tMid = std::chrono::steady_clock::now() - start;
+
+	std::cout << std::setw(6) << name << std::setw(6) << prefixLength << std::fixed << std::setprecision(0)
+		<< std::setw(14) << MIDSTATE_NONCES / tFull.count()
+		<< std::setw(14) << MIDSTATE_NONCES / tMid.count()
+		<< std::setprecision(2) << std::setw(8) << tFull.count() / tMid.count() << "x\n";
+
+	return sumFull == sumMid;
+}
+
+// Multi-lane kernel at specified instruction set.
+typedef void(*LaneFunc)(SimdLevel, uint32_t, const LaneMessages&, uint32_t[HASH_LANES]);
+
+// Cross-check multi-lane kernel against scalar hash function using nonce 
+// digits, then random length messages of random bytes.
+template <HashFunc hf>
+static bool crossCheck(LaneFunc lanesFunc, SimdLevel level)
+{
+	Hash<hf> h;
+	typename Hash<hf>::State prefix = h.init();
+	uint32_t out[HASH_LANES];
+	std::mt19937 mt(SEED);
+
+	h.update(prefix, "3141592653", 10);
+
+	NonceLanes nonces(0);
+	for (unsigned long n = 0; n < CROSS_CHECK_INPUTS; n += HASH_LANES, nonces.advance())
+	{
+		lanesFunc(level, prefix.hash, nonces, out);
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			if (out[lane] != h.hashString("3141592653" + std::to_string(n + lane)))
+				return false;
+	}
+
+	LaneMessages m;
+	for (unsigned long n = 0; n < CROSS_CHECK_INPUTS; n += HASH_LANES)
+	{
+		m.maxLength = 0;
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		{
+			m.length[lane] = static_cast<uint8_t>(mt() % (MAX_LANE_BYTES + 1));
+			if (m.length[lane] > m.maxLength)
+				m.maxLength = m.length[lane];
+		}
+		for (auto& b : m.bytes)
+			b = static_cast<uint8_t>(mt());
+
+		lanesFunc(level, prefix.hash, m, out);
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		{
+			char key[MAX_LANE_BYTES];
+			typename Hash<hf>::State state(prefix);
+
+			for (std::size_t i = 0; i < m.length[lane]; i++)
+				key[i] = static_cast<char>(m.bytes[i * HASH_LANES + lane]);
+			h.update(state, key, m.length[lane]);
+			if (out[lane] != h.finalize(state))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Time hashing nonces with multi-lane kernel, returns hashes/s.
+static double laneRate(LaneFunc lanesFunc, SimdLevel level)
+{
+	NonceLanes nonces(0);
+	uint32_t out[HASH_LANES], sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long n = 0; n < LANE_NONCES; n += HASH_LANES, nonces.advance())
+	{
+		lanesFunc(level, FNV1A_32_INIT, nonces, out);
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			sum += out[lane];
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// Keep sum alive.
+	if (sum == 1)
+		std::cout << ' ';
+
+	return LANE_NONCES / elapsed.count();
+}
+
+// Time hashing nonces with scalar midstate, returns hashes/s.
+template <HashFunc hf>
+static double scalarRate()
+{
+	Hash<hf> h;
+	typename Hash<hf>::State prefix = h.init();
+	uint32_t sum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long n = 0; n < LANE_NONCES; n++)
+	{
+		char digits[20];
+		char *end = std::to_chars(digits, digits + sizeof(digits), n).ptr;
+		typename Hash<hf>::State state(prefix);
+		h.update(state, digits, end - digits);
+		sum += h.finalize(state);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (sum == 1)
+		std::cout << ' ';
+
+	return LANE_NONCES / elapsed.count();
+}
+
+// Check FNV-1a 64 and XXH64 (seed 0) against reference digests, hashed at
+// once and in uneven pieces. Then check random messages streamed in random
+// pieces (crossing XXH64's 32 byte stripes) match one-shot hashing.
+static bool hash64Vectors()
+{
+	const struct { std::string message; uint64_t fnv1a64; uint64_t xxh64; } vectors[] = {
+		{ "", 0xcbf29ce484222325, 0xef46db3751d8e999 },
+		{ "a", 0xaf63dc4c8601ec8c, 0xd24ec4f1a98c6e5b },
+		{ "abc", 0xe71fa2190541574b, 0x44bc2cf5ad770999 },
+		{ "foobar", 0x85944171f73967e8, 0xa2aa05ed9085aaf9 },
+		{ "Nobody inspects the spammish repetition", 0x0637a291fd6c205b, 0xfbcea83c8a378bf1 },
+		{ "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+			0xf3692984963deb8d, 0xbafc02122ded1d21 },
+		{ std::string(1000000, 'a'), 0x24c638d05c2865e5, 0xdc483aaa9b4fdc40 },
+	};
+
+	for (const auto& v : vectors)
+	{
+		Fnv1a64::State fnv;
+		XxHash64::State xxh;
+
+		for (std::size_t i = 0, n = 1; i < v.message.length(); i += n, n = n * 3 % 97 + 1)
+		{
+			fnv.update(std::string_view(v.message).substr(i, n));
+			xxh.update(std::string_view(v.message).substr(i, n));
+		}
+		if (Fnv1a64::hash(v.message) != v.fnv1a64 || fnv.finalize() != v.fnv1a64
+			|| XxHash64::hash(v.message) != v.xxh64 || xxh.finalize() != v.xxh64)
+			return false;
+	}
+
+	std::mt19937 mt(SEED);
+	for (std::size_t len = 0; len <= 256; len++)
+	{
+		std::string message(len, '\0');
+		Fnv1a64::State fnv;
+		XxHash64::State xxh;
+
+		for (auto& c : message)
+			c = static_cast<char>(mt());
+		for (std::size_t i = 0, n; i < len; i += n)
+		{
+			n = std::min<std::size_t>(mt() % 40, len - i);
+			fnv.update(std::string_view(message).substr(i, n));
+			xxh.update(std::string_view(message).substr(i, n));
+		}
+		if (fnv.finalize() != Fnv1a64::hash(message) || xxh.finalize() != XxHash64::hash(message))
+			return false;
+	}
+
+	return true;
+}
+
+// Check SHA-256 and double SHA-256 against FIPS 180-4 test vectors, hashed
+// at once and in uneven pieces.
+static bool sha256Vectors()
+{
+	const struct { std::string message; const char* sha256; const char* sha256d; } vectors[] = {
+		{ "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", nullptr },
+		{ "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", 
+			"4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358" },
+		{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 
+			"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", nullptr },
+		{ "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+			"cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1", nullptr },
+		{ std::string(1000000, 'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", nullptr },
+	};
+
+	for (const auto& v : vectors)
+	{
+		Sha256::State state;
+
+		for (std::size_t i = 0, n = 1; i < v.message.length(); i += n, n = n * 3 % 97 + 1)
+			state.update(std::string_view(v.message).substr(i, n));
+		if (digestString(Sha256::hash(v.message)) != v.sha256 || digestString(state.finalize()) != v.sha256)
+			return false;
+		if (v.sha256d && digestString(Sha256d::hash(v.message)) != v.sha256d)
+			return false;
+	}
+
+	return true;
+}
+
+// Cross-check SHA-256 lane kernel against Sha256/Sha256d, for nonces after 
+// prefixes of every length up to 2 blocks (so final blocks split at every
+// position), and nonces gaining a digit.
+static bool sha256CrossCheck(Sha256Kernel kernel)
+{
+	const unsigned long FIRST_NONCES[] = { 0, 96, 999992, 4294967290 };
+	std::mt19937 mt(SEED);
+	Digest256 out[HASH_LANES];
+
+	for (std::size_t len = 0; len <= 128; len++)
+	{
+		std::string prefix(len, ' ');
+		for (auto& c : prefix)
+			c = static_cast<char>('0' + mt() % 75);
+
+		Sha256::State s;
+		s.update(prefix);
+
+		for (unsigned long first : FIRST_NONCES)
+		{
+			NonceLanes nonces(first);
+
+			for (int step = 0; step < 4; step++, nonces.advance())
+				for (bool twice : { false, true })
+				{
+					sha256_lanes(kernel, s, nonces, out, twice);
+					for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+					{
+						std::string message = prefix + std::to_string(nonces.nonce(lane));
+						if (out[lane] != (twice ? Sha256d::hash(message) : Sha256::hash(message)))
+							return false;
+					}
+				}
+		}
+	}
+
+	return true;
+}
+
+// Time mining hashes of nonces after a 64 hex digit previous hash, with
+// scalar midstate (kernel nullptr) or lane kernel. Returns hashes/s.
+static double sha256Rate(const Sha256Kernel* kernel, bool twice)
+{
+	Sha256::State prefix;
+	NonceLanes nonces(0);
+	Digest256 out[HASH_LANES];
+	uint32_t sum = 0;
+
+	prefix.update(digestString(Sha256::hash("269")));
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long n = 0; n < SHA256_NONCES; n += HASH_LANES, nonces.advance())
+	{
+		if (kernel)
+			sha256_lanes(*kernel, prefix, nonces, out, twice);
+		else
+			for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			{
+				Sha256::State state(prefix);
+				state.update(std::to_string(n + lane));
+				out[lane] = twice ? Sha256d::rehash(state.finalize()) : state.finalize();
+			}
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			sum += out[lane].bytes[0] << 24 | out[lane].bytes[1] << 16 | out[lane].bytes[2] << 8 | out[lane].bytes[3];
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (sum == 1)
+		std::cout << ' ';
+
+	return SHA256_NONCES / elapsed.count();
+}
+
+// SHA-256 test vectors, lane kernel cross-check and mining rates.
+static bool sha256Kernels()
+{
+	if (!sha256Vectors())
+	{
+		std::cout << "SHA-256 test vector mismatch\n";
+		return false;
+	}
+	std::cout << "\nSHA-256 matches FIPS 180-4 test vectors.\n"
+		<< "SHA-256 mining kernels (hashes/s), best " << sha256KernelName(sha256Kernel()) << ":\n"
+		<< "  kernel        sha256       sha256d\n" << std::fixed << std::setprecision(0);
+
+	double rate = sha256Rate(nullptr, false), rateDouble = sha256Rate(nullptr, true);
+	std::cout << std::setw(8) << "midst" << std::setw(14) << rate << std::setw(14) << rateDouble << "\n";
+
+	for (Sha256Kernel kernel : { Sha256Kernel::Scalar, Sha256Kernel::SSE2, Sha256Kernel::AVX2, Sha256Kernel::SHA_NI })
+	{
+		if (kernel == Sha256Kernel::SHA_NI ? !hasShaNi() : kernel == Sha256Kernel::AVX2 ? simdLevel() < SimdLevel::AVX2 
+			: kernel == Sha256Kernel::SSE2 && simdLevel() < SimdLevel::SSE2)
+			continue;
+		if (!sha256CrossCheck(kernel))
+		{
+			std::cout << sha256KernelName(kernel) << " SHA-256 kernel mismatch\n";
+			return false;
+		}
+		rate = sha256Rate(&kernel, false);
+		rateDouble = sha256Rate(&kernel, true);
+		std::cout << std::setw(8) << sha256KernelName(kernel) << std::setw(14) << rate << std::setw(14) << rateDouble << "\n";
+	}
+	std::cout << "SHA-256 kernels match Sha256/Sha256d.\n";
+
+	return true;
+}
+
+// CRC-32 update function.
+typedef uint32_t(*CrcFunc)(uint32_t, const char*, std::size_t);
+
+// Time CRC-32 over messages of given length, returns MB/s and crc of all.
+static double crcRate(CrcFunc crc, const std::string& data, std::size_t len, uint32_t& result)
+{
+	std::size_t count = CRC_BYTES / len;
+
+	result = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < count; i++)
+		result ^= crc(CRC_32_INIT, data.data() + (i * 13) % 64, len);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return (count * len) / elapsed.count() / 1e6;
+}
+
+// Benchmark CRC-32 variants, returns false if results differ.
+static bool crcVariants()
+{
+	const struct { const char* name; CrcFunc func; } variants[] = {
+		{ "bitwise", crc_32_update_bitwise },
+		{ "slice4", crc_32_slicing<4> },
+		{ "slice8", crc_32_slicing<8> },
+		{ "pclmul", crc_32_update_pclmul },
+	};
+	std::string data(CRC_LENGTHS[std::size(CRC_LENGTHS) - 1] + 64, '\0');
+	std::mt19937 mt(SEED);
+
+	for (auto& c : data)
+		c = static_cast<char>(mt());
+
+	std::cout << "\nCRC-32 (MB/s), CPU " << (hasPclmul() ? "supports" : "does not support") << " pclmul:\n"
+		<< "    len";
+	for (auto& v : variants)
+		std::cout << std::setw(10) << v.name;
+	std::cout << "\n" << std::setprecision(0);
+
+	for (std::size_t len : CRC_LENGTHS)
+	{
+		uint32_t expected = 0, result;
+
+		std::cout << std::setw(7) << len;
+		for (auto& v : variants)
+		{
+			std::cout << std::setw(10) << crcRate(v.func, data, len, result);
+			if (&v == variants)
+				expected = result;
+			else if (result != expected)
+				return false;
+		}
+		std::cout << "\n";
+	}
+
+	return true;
+}
+
+// Validate chain with increasing thread counts, then check corrupted
+// blocks are found.
+static bool chainValidation()
+{
+	std::vector<CompactBlock> chain;
+	uint32_t hash = 0;
+
+	chain.reserve(VALIDATE_BLOCKS);
+	for (std::size_t i = 0; i < VALIDATE_BLOCKS; i++)
+	{
+		chain.emplace_back(i, hash, i);
+		hash = chain.back().getHash();
+	}
+
+	std::cout << "\nValidate " << VALIDATE_BLOCKS << " block chain (blocks/s):\n"
+		<< "threads          rate speedup\n";
+
+	unsigned int hw = std::max(1u, std::thread::hardware_concurrency());
+	double single = 0;
+	for (unsigned int threads = 1; ; threads = std::min(threads * 2, hw))
+	{
+		ChainStatus status;
+		auto start = std::chrono::steady_clock::now();
+		status = validateChain(chain.data(), chain.size(), 0, threads);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (!status.valid())
+			return false;
+		if (threads == 1)
+			single = elapsed.count();
+		std::cout << std::setw(7) << threads << std::setw(14) << std::setprecision(0) << VALIDATE_BLOCKS / elapsed.count()
+			<< std::setw(7) << std::setprecision(2) << single / elapsed.count() << "x\n";
+		if (threads == hw)
+			break;
+	}
+
+	// Corrupt one block at a time (and a later one), expect the first reported.
+	const struct { std::size_t index; ChainError error; } corrupt[] = {
+		{ 0, ChainError::Hash }, { VALIDATE_BLOCKS / 3, ChainError::Link }, 
+		{ VALIDATE_BLOCKS / 2, ChainError::Id }, { VALIDATE_BLOCKS - 1, ChainError::Hash } };
+	for (auto& c : corrupt)
+	{
+		CompactBlock saved = chain[c.index], later = chain.back();
+
+		if (c.error == ChainError::Hash)
+			chain[c.index].setNonce(chain[c.index].getNonce() + 1);
+		else if (c.error == ChainError::Link)
+			chain[c.index] = CompactBlock(c.index, chain[c.index].getPreviousHash() + 1, c.index);
+		else
+			chain[c.index].setID(c.index + 1);
+		chain.back().setNonce(later.getNonce() + 1);
+
+		ChainStatus status = validateChain(chain.data(), chain.size(), 0);
+		chain[c.index] = saved;
+		if (c.index != VALIDATE_BLOCKS - 1)
+			chain.back() = later;
+
+		if (status.index != c.index || status.error != c.error)
+		{
+			std::cout << "Expected " << chainErrorName(c.error) << " error at block " << c.index << ", found "
+				<< chainErrorName(status.error) << " at " << status.index << "\n";
+			return false;
+		}
+	}
+	std::cout << "Corrupted blocks found (hash, link, id).\n";
+
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int difficulty = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : DEFAULT_DIFFICULTY;
+	unsigned long blocks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : DEFAULT_BLOCKS;
+
+	std::vector<MineResult> before, after;
+	unsigned long long attemptsBefore, attemptsAfter;
+
+	std::cout << "Mining " << blocks << " blocks at difficulty level: " << difficulty << std::endl;
+
+	double tBefore = mineChain([=](unsigned long, const std::string& ph) { return legacyMine(ph, difficulty); },
+		blocks, before, attemptsBefore);
+
+	double tAfter = mineChain([=](unsigned long i, const std::string& ph)
+	{
+		Block b(i, ph, 0);
+		b.MineBlock(difficulty);
+		return MineResult{ b.getNonce(), b.getHash() };
+	}, blocks, after, attemptsAfter);
+
+	for (unsigned long i = 0; i < blocks; i++)
+		if (before[i].nonce != after[i].nonce || before[i].hash != after[i].hash)
+		{
+			std::cout << "Mismatch at block " << i << std::endl;
+			return EXIT_FAILURE;
+		}
+
+	report("stringstream", attemptsBefore, tBefore);
+	report("MineBlock", attemptsAfter, tAfter);
+	std::cout << "Speedup: " << std::setprecision(2) << tBefore / tAfter << "x\n";
+
+	std::cout << "\nPrevious hash midstate (hashes/s):\n"
+		<< "  hash   len          full      midstate speedup\n";
+	bool ok = true;
+	for (std::size_t len : PREFIX_LENGTHS)
+	{
+		ok &= midstate<fnv1a_32>("fnv1a", len);
+		ok &= midstate<crc_32>("crc", len);
+		ok &= midstate<sdbm_32>("sdbm", len);
+	}
+	if (!ok)
+	{
+		std::cout << "Midstate mismatch\n";
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "\nMulti-lane kernels (hashes/s), CPU supports " << simdLevelName(simdLevel()) << ":\n"
+		<< "  hash  level          rate\n" << std::setprecision(0)
+		<< std::setw(6) << "fnv1a" << std::setw(7) << "midst" << std::setw(14) << scalarRate<fnv1a_32>() << "\n"
+		<< std::setw(6) << "sdbm" << std::setw(7) << "midst" << std::setw(14) << scalarRate<sdbm_32>() << "\n";
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 })
+	{
+		if (level > simdLevel())
+			break;
+		if (!crossCheck<fnv1a_32>(fnv1a_32_lanes, level) || !crossCheck<sdbm_32>(sdbm_32_lanes, level))
+		{
+			std::cout << simdLevelName(level) << " kernel mismatch\n";
+			return EXIT_FAILURE;
+		}
+		std::cout << std::setw(6) << "fnv1a" << std::setw(7) << simdLevelName(level) << std::setw(14) << laneRate(fnv1a_32_lanes, level) << "\n"
+			<< std::setw(6) << "sdbm" << std::setw(7) << simdLevelName(level) << std::setw(14) << laneRate(sdbm_32_lanes, level) << "\n";
+	}
+	std::cout << "Multi-lane kernels match scalar functions (" << 2 * CROSS_CHECK_INPUTS << " inputs each).\n";
+
+	if (!crcVariants())
+	{
+		std::cout << "CRC-32 variant mismatch\n";
+		return EXIT_FAILURE;
+	}
+
+	if (!hash64Vectors())
+	{
+		std::cout << "FNV-1a 64/XXH64 reference digest mismatch\n";
+		return EXIT_FAILURE;
+	}
+	std::cout << "\nFNV-1a 64 and XXH64 match reference digests.\n";
+
+	if (!sha256Kernels())
+		return EXIT_FAILURE;
+
+	if (!chainValidation())
+	{
+		std::cout << "Chain validation failed\n";
+		return EXIT_FAILURE;
+	}
+
+	return 0;
+}
@@ -0,0 +1,404 @@
+/*************************************************************************
+* Title: Mining Benchmark
+* File: bench_mining.cpp
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Mining throughput benchmark. Mines a chain for every combination of hash
+* function, difficulty, chain length and thread count, and reports:
+*
+*   hashes/s     nonces searched (winning nonce + 1 per block) per second.
+*   blocks/s     blocks mined per second.
+*   p50, p99     block mining latency (milliseconds).
+*   rss          peak resident memory of the process (KB).
+*
+* The genesis previous hash comes from a fixed seed, so every run mines the
+* same chains. The hash of the last block of each chain is reported, and
+* must be the same for every thread count. Each hash function mines with
+* its own BasicBlock<Hasher>, so the search loop is compiled for it. Results are printed as a table,
+* and optionally written as JSON to compare builds.
+*
+* With --batch, instead mines a batch of independent chains with skewed
+* difficulty (every BATCH_HARD_EVERY'th job hard, the rest easy) three
+* ways, for each thread count:
+*
+*   serial     jobs one after another, each block mined by all threads.
+*   static     jobs dealt to threads in turn, one thread per job.
+*   stealing   work-stealing scheduler (scheduler.h).
+*
+* All three must mine the same blocks.
+*
+* Usage: bench_mining [--hash stl,fnv1a,crc,sdbm,fnv1a64,xxh64,sha256,sha256d]
+*                     [--difficulty 2,3,4]
+*                     [--blocks 200] [--threads 1,0] [--seed 269]
+*                     [--json file]
+*        bench_mining --batch 64 [--threads 1,0] [--seed 269]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 -pthread bench_mining.cpp block.cpp hash_simd.cpp
+*  (2) A thread count of 0 uses all hardware threads.
+*  (3) Peak memory never decreases, so rss is the peak up to and including
+*      that run.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Added 64 and 256-bit hashers, mined by BasicBlock<Hasher>.
+*               JME
+*   10/17/2026: Added double SHA-256. JME
+*   10/17/2026: Added --batch, skewed batch of chains mined serially,
+*               statically split and by the work-stealing scheduler. JME
+*************************************************************************/
+#include <algorithm> // sort
+#include <chrono>    // timing
+#include <cstdlib>   // strtoul
+#include <cstring>   // strcmp
+#include <fstream>   // json file
+#include <iomanip>   // manipulators
+#include <iostream>  // cout
+#include <random>    // mt19937
+#include <sstream>   // list parsing
+#include <string>    // strings
+#include <thread>    // hardware concurrency
+#include <vector>    // results
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>   // GetProcessMemoryInfo (link psapi.lib)
+#else
+#include <sys/resource.h> // getrusage
+#endif
+
+#include "block.h"
+#include "hash_funcs.h"
+#include "hashers.h"
+#include "hash_simd.h"
+#include "scheduler.h"
+
+using namespace myBlock;
+using namespace myMining;
+
+// Default benchmark parameters.
+constexpr unsigned int DEFAULT_SEED = 269;
+constexpr unsigned long DEFAULT_BLOCKS = 200;
+// Skewed batch: blocks per job, easy and hard difficulty, every nth job hard.
+constexpr unsigned long BATCH_BLOCKS = 4;
+constexpr unsigned int BATCH_EASY = 2;
+constexpr unsigned int BATCH_HARD = 5;
+constexpr unsigned long BATCH_HARD_EVERY = 8;
+
+// Result of mining one chain.
+struct RunResult
+{
+	const char* hash;
+	unsigned int difficulty;
+	unsigned long blocks;
+	unsigned int threads;
+	double seconds;
+	double hashesPerSec;
+	double blocksPerSec;
+	double p50Ms;
+	double p99Ms;
+	long peakRssKB;
+	std::string lastHash;
+};
+
+// Peak resident memory of process (KB).
+static long peakRssKB()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS pmc;
+	return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? static_cast<long>(pmc.PeakWorkingSetSize / 1024) : 0;
+#else
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) ? 0 : usage.ru_maxrss; // KB on Linux.
+#endif
+}
+
+// Value at percentile p (0-100) of sorted values.
+static double percentile(const std::vector<double>& sorted, double p)
+{
+	std::size_t i = static_cast<std::size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(i, sorted.size() - 1)];
+}
+
+// Mine chain of blocks, starting each nonce search at 0 (as main.cpp does).
+template <class Hasher>
+static RunResult mineChain(const char* name, unsigned int difficulty, unsigned long blocks, unsigned int threads, unsigned int seed)
+{
+	typedef BasicBlock<Hasher> MiningBlock;
+
+	std::mt19937 mt(seed);
+	std::string previousHash = std::to_string(mt());
+	std::vector<double> latency;
+	unsigned long long hashes = 0;
+
+	latency.reserve(blocks);
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long i = 0; i < blocks; i++)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		unsigned long nonce = MiningBlock::findNonce(previousHash, 0, difficulty, threads);
+		previousHash = digestString(MiningBlock::calcHash(previousHash, nonce));
+		std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - t0;
+
+		latency.push_back(ms.count());
+		hashes += nonce + 1;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::sort(latency.begin(), latency.end());
+	double seconds = elapsed.count();
+	return RunResult{ name, difficulty, blocks, threads, seconds, hashes / seconds, blocks / seconds,
+		percentile(latency, 50), percentile(latency, 99), peakRssKB(), previousHash };
+}
+
+// Benchmarked hash functions.
+const struct { const char* name; RunResult (*mine)(const char*, unsigned int, unsigned long, unsigned int, unsigned int); } HASHES[] = {
+	{ "stl", mineChain<Stl32> }, { "fnv1a", mineChain<Fnv1a32> }, { "crc", mineChain<Crc32> }, { "sdbm", mineChain<Sdbm32> },
+	{ "fnv1a64", mineChain<Fnv1a64> }, { "xxh64", mineChain<XxHash64> }, { "sha256", mineChain<Sha256> }, { "sha256d", mineChain<Sha256d> },
+};
+
+// Batch of chains, each with a random previous hash.
+static std::vector<MiningJob> skewedBatch(unsigned long jobs, unsigned int seed)
+{
+	std::mt19937 mt(seed);
+	std::vector<MiningJob> batch;
+
+	for (unsigned long j = 0; j < jobs; j++)
+		batch.push_back(MiningJob{ std::to_string(mt()), j % BATCH_HARD_EVERY ? BATCH_EASY : BATCH_HARD, 0, BATCH_BLOCKS });
+	return batch;
+}
+
+// Mine job one block after another (MineBlock threads).
+static std::vector<Block> mineJob(const MiningJob& job, unsigned int threads)
+{
+	std::vector<Block> blocks;
+	std::string hash = job.previousHash;
+
+	for (unsigned long id = job.firstId; id < job.lastId; id++)
+	{
+		Block b(id, hash, 0);
+
+		b.MineBlock(job.difficulty, threads);
+		hash = b.getHash();
+		blocks.push_back(b);
+	}
+	return blocks;
+}
+
+// Mine batch (mode, threads), returns blocks of each job.
+static std::vector<std::vector<Block>> mineBatch(const std::string& mode, const std::vector<MiningJob>& batch, unsigned int threads)
+{
+	std::vector<std::vector<Block>> chains(batch.size());
+
+	if (mode == "serial")
+	{
+		for (std::size_t j = 0; j < batch.size(); j++)
+			chains[j] = mineJob(batch[j], threads);
+	}
+	else if (mode == "static")
+	{
+		std::vector<std::thread> pool;
+
+		for (unsigned int t = 0; t < threads; t++)
+			pool.emplace_back([&, t]()
+			{
+				for (std::size_t j = t; j < batch.size(); j += threads)
+					chains[j] = mineJob(batch[j], 1);
+			});
+		for (auto& t : pool)
+			t.join();
+	}
+	else
+	{
+		Scheduler scheduler(threads);
+		auto results = scheduler.submit(batch);
+
+		for (std::size_t j = 0; j < batch.size(); j++)
+			chains[j] = results[j].get();
+	}
+	return chains;
+}
+
+// Run skewed batch each way, for each thread count. Returns false on mismatch.
+static bool batchBenchmark(unsigned long jobs, const std::vector<unsigned long>& threadCounts, unsigned int seed)
+{
+	const std::vector<MiningJob> batch = skewedBatch(jobs, seed);
+	std::vector<std::vector<Block>> reference;
+
+	std::cout << "Batch of " << jobs << " chains, " << BATCH_BLOCKS << " blocks each, difficulty " << BATCH_EASY
+		<< " (every " << BATCH_HARD_EVERY << "th " << BATCH_HARD << "), seed " << seed << ":\n"
+		<< "     mode thr   seconds      hashes/s\n";
+
+	for (unsigned long threads : threadCounts)
+		for (const char* mode : { "serial", "static", "stealing" })
+		{
+			auto start = std::chrono::steady_clock::now();
+			std::vector<std::vector<Block>> chains = mineBatch(mode, batch, threads);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			unsigned long long hashes = 0;
+
+			for (auto& chain : chains)
+				for (auto& b : chain)
+					hashes += b.getNonce() + 1;
+
+			std::cout << std::setw(9) << mode << std::setw(4) << threads << std::fixed << std::setprecision(3)
+				<< std::setw(10) << elapsed.count() << std::setprecision(0) << std::setw(14) << hashes / elapsed.count() << "\n";
+
+			// Every way must mine the same chains.
+			if (reference.empty())
+				reference = chains;
+			for (std::size_t j = 0; j < batch.size(); j++)
+				for (std::size_t i = 0; i < chains[j].size(); i++)
+					if (chains[j].size() != reference[j].size() || chains[j][i].getHash() != reference[j][i].getHash())
+					{
+						std::cout << "Chain mismatch: " << mode << " job " << j << ", " << threads << " threads\n";
+						return false;
+					}
+		}
+	return true;
+}
+
+// Parse comma separated list of numbers.
+static std::vector<unsigned long> parseList(const char* arg)
+{
+	std::vector<unsigned long> values;
+	std::stringstream ss(arg);
+	std::string item;
+
+	while (std::getline(ss, item, ','))
+		values.push_back(std::strtoul(item.c_str(), nullptr, 10));
+	return values;
+}
+
+// Write results as JSON.
+static void writeJson(std::ostream& os, const std::vector<RunResult>& results, unsigned int seed)
+{
+	os << std::fixed << std::setprecision(3)
+		<< "{\n  \"benchmark\": \"mining\",\n  \"seed\": " << seed
+		<< ",\n  \"simd\": \"" << simdLevelName(simdLevel()) << "\""
+		<< ",\n  \"sha256Kernel\": \"" << sha256KernelName(sha256Kernel()) << "\""
+		<< ",\n  \"hardwareThreads\": " << std::thread::hardware_concurrency()
+		<< ",\n  \"results\": [\n";
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const RunResult& r = results[i];
+
+		os << "    { \"hash\": \"" << r.hash << "\", \"difficulty\": " << r.difficulty << ", \"blocks\": " << r.blocks
+			<< ", \"threads\": " << r.threads << ", \"seconds\": " << std::setprecision(6) << r.seconds
+			<< ", \"hashesPerSec\": " << std::setprecision(0) << r.hashesPerSec
+			<< ", \"blocksPerSec\": " << std::setprecision(3) << r.blocksPerSec
+			<< ", \"p50Ms\": " << r.p50Ms << ", \"p99Ms\": " << r.p99Ms
+			<< ", \"peakRssKB\": " << r.peakRssKB << ", \"lastHash\": \"" << r.lastHash << "\" }"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+
+	os << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> hashNames;
+	std::vector<unsigned long> difficulties{ 2, 3, 4 }, lengths{ DEFAULT_BLOCKS }, threadCounts{ 1, 0 };
+	unsigned int seed = DEFAULT_SEED;
+	const char* jsonFile = nullptr;
+	unsigned long batchJobs = 0;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (!std::strcmp(argv[i], "--hash"))
+		{
+			std::stringstream ss(argv[i + 1]);
+			std::string item;
+			while (std::getline(ss, item, ','))
+				hashNames.push_back(item);
+		}
+		else if (!std::strcmp(argv[i], "--difficulty"))
+			difficulties = parseList(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--blocks"))
+			lengths = parseList(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--threads"))
+			threadCounts = parseList(argv[i + 1]);
+		else if (!std::strcmp(argv[i], "--seed"))
+			seed = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--json"))
+			jsonFile = argv[i + 1];
+		else if (!std::strcmp(argv[i], "--batch"))
+			batchJobs = std::strtoul(argv[i + 1], nullptr, 10);
+		else
+		{
+			std::cout << "Unknown option " << argv[i] << "\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Thread count 0 means all hardware threads.
+	for (auto& t : threadCounts)
+		if (t == 0)
+			t = std::max(1u, std::thread::hardware_concurrency());
+	threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+	if (batchJobs)
+		return batchBenchmark(batchJobs, threadCounts, seed) ? 0 : EXIT_FAILURE;
+
+	std::vector<RunResult> results;
+	std::cout << "Mining benchmark, seed " << seed << ", " << simdLevelName(simdLevel()) << ", SHA-256 " << sha256KernelName(sha256Kernel()) << ":\n"
+		<< "     hash diff  blocks thr      hashes/s    blocks/s   p50 ms   p99 ms  rss KB\n";
+
+	try
+	{
+		for (auto& h : HASHES)
+		{
+			if (!hashNames.empty() && std::find(hashNames.begin(), hashNames.end(), h.name) == hashNames.end())
+				continue;
+
+			for (unsigned long difficulty : difficulties)
+				for (unsigned long blocks : lengths)
+				{
+					if (!blocks)
+						continue;
+
+					for (unsigned long threads : threadCounts)
+					{
+						RunResult r = h.mine(h.name, difficulty, blocks, threads, seed);
+
+						std::cout << std::setw(9) << r.hash << std::setw(5) << r.difficulty << std::setw(8) << r.blocks
+							<< std::setw(4) << r.threads << std::fixed << std::setprecision(0) << std::setw(14) << r.hashesPerSec
+							<< std::setprecision(1) << std::setw(12) << r.blocksPerSec << std::setprecision(3)
+							<< std::setw(9) << r.p50Ms << std::setw(9) << r.p99Ms << std::setw(8) << r.peakRssKB << "\n";
+
+						// Search is deterministic, every thread count must mine the same chain.
+						if (threads != threadCounts.front() && r.lastHash != results.back().lastHash)
+						{
+							std::cout << "Chain mismatch: " << r.hash << " difficulty " << difficulty << ", " << threads << " threads\n";
+							return EXIT_FAILURE;
+						}
+						results.push_back(r);
+					}
+				}
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "Encountered exception: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (jsonFile)
+	{
+		std::ofstream json(jsonFile);
+
+		writeJson(json, results, seed);
+		if (!json)
+		{
+			std::cout << "Unable to write " << jsonFile << "\n";
+			return EXIT_FAILURE;
+		}
+		std::cout << "Results written to " << jsonFile << "\n";
+	}
+
+	return 0;
+}
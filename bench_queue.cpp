@@ -0,0 +1,139 @@
+/*************************************************************************
+* Title: Queue Benchmark
+* File: bench_queue.cpp
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Contention benchmark of myQueue::MpmcQueue against a mutex guarded
+* myQueue::Queue, for 1 to 64 threads. Each thread repeatedly enqueues a
+* value then dequeues one, so every thread is both a producer and a
+* consumer. Checks the sum of values dequeued matches the sum enqueued.
+*
+* Usage: bench_queue [pairs]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 -pthread bench_queue.cpp
+*  (2) Pairs (enqueue + dequeue) are split evenly across threads.
+*  (3) Thread counts above the number of cores measure behavior under
+*      preemption rather than contention.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*************************************************************************/
+#include <atomic>    // sums
+#include <chrono>    // timing
+#include <cstdlib>   // strtoul
+#include <iomanip>   // manipulators
+#include <iostream>  // cout
+#include <mutex>     // locked queue
+#include <thread>    // threads
+#include <vector>    // threads
+
+#include "mpmc_queue.h"
+#include "queue.h"
+
+using namespace myQueue;
+
+// Default number of enqueue/dequeue pairs.
+constexpr unsigned long DEFAULT_PAIRS = 4000000;
+// Thread counts.
+constexpr unsigned int THREADS[] = { 1, 2, 4, 8, 16, 32, 64 };
+// Queue size, must hold one element per thread.
+constexpr std::size_t BENCH_QUEUE_SIZE = 1024;
+
+// Queue guarded by a mutex.
+class LockedQueue
+{
+	std::mutex lock;
+	Queue<unsigned long, GROWABLE> q;
+
+public:
+	void enqueue(unsigned long val)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		q.enqueue(val);
+	}
+
+	bool tryDequeue(unsigned long& val)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (q.empty())
+			return false;
+		val = q.front();
+		q.dequeue();
+		return true;
+	}
+};
+
+// Adapter giving MpmcQueue the same interface.
+class LockFreeQueue
+{
+	MpmcQueue<unsigned long, BENCH_QUEUE_SIZE> q;
+
+public:
+	void enqueue(unsigned long val) { q.enqueue(val); }
+	bool tryDequeue(unsigned long& val) { return q.tryDequeue(val); }
+};
+
+// Run pairs split across threads, returns pairs/s (0 if sums differ).
+template <class QueueType>
+static double pairRate(unsigned int threads, unsigned long pairs)
+{
+	QueueType q;
+	std::atomic<unsigned long long> sum(0);
+	const unsigned long perThread = pairs / threads;
+
+	auto worker = [&](unsigned int t)
+	{
+		unsigned long long local = 0;
+		unsigned long val;
+
+		for (unsigned long i = 0; i < perThread; i++)
+		{
+			q.enqueue(t * perThread + i);
+			// Another thread may have taken our value, but one is always queued.
+			while (!q.tryDequeue(val))
+				std::this_thread::yield();
+			local += val;
+		}
+		sum += local;
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (unsigned int t = 0; t < threads; t++)
+		pool.emplace_back(worker, t);
+	for (auto& t : pool)
+		t.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// Values 0 to (threads * perThread - 1) each dequeued once.
+	unsigned long long n = static_cast<unsigned long long>(threads) * perThread;
+	return sum == n * (n - 1) / 2 ? n / elapsed.count() : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long pairs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : DEFAULT_PAIRS;
+
+	std::cout << pairs << " enqueue/dequeue pairs (pairs/s), " << std::thread::hardware_concurrency() << " hardware threads:\n"
+		<< "threads        locked     lock-free speedup\n";
+
+	for (unsigned int threads : THREADS)
+	{
+		double locked = pairRate<LockedQueue>(threads, pairs);
+		double lockFree = pairRate<LockFreeQueue>(threads, pairs);
+
+		if (locked == 0 || lockFree == 0)
+		{
+			std::cout << "Sum mismatch at " << threads << " threads\n";
+			return EXIT_FAILURE;
+		}
+
+		std::cout << std::setw(7) << threads << std::fixed << std::setprecision(0) << std::setw(14) << locked
+			<< std::setw(14) << lockFree << std::setw(7) << std::setprecision(2) << lockFree / locked << "x\n";
+	}
+
+	return 0;
+}
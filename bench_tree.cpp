@@ -0,0 +1,446 @@
+/*************************************************************************
+* Title: Tree Benchmark
+* File: bench_tree.cpp
+* Author: James Eli
+* Date: 10/16/2026
+*
+* Benchmarks myTree::Tree<Block> (pool allocated nodes, unbalanced and AVL)
+* against the original shared pointer node layout. Times insert, random
+* finds, in-order traversal and clear for a tree of random nonce blocks.
+* The shared pointer tree searches its whole tree on each find, so it only
+* does SHARED_FINDS finds, the pool trees do LOOKUPS. Then times random
+* lookups in the pointer trees against their frozen (Eytzinger ordered)
+* snapshot, by nonce and by id. The compact row stores fixed-width
+* CompactBlocks (compact_block.h) instead of Blocks. Last, compares 
+* printing traversal against visitor and iterator traversals. Then times
+* bulkLoad() and merge() against adding blocks one at a time, for random
+* and sorted nonces, and checks they build the same in-order sequence as
+* add() and insertUnique(), and that the parallel sort is stable. Finally,
+* times id and hash lookups and chain walks in the flat block index
+* (block_index.h) against std::unordered_map, with its probe lengths and
+* memory per entry, and checks a walk from the tip reaches every block.
+*
+* Usage: bench_tree [blocks]
+*
+* Notes:
+*  (1) Build: g++ -std=c++17 -O2 -pthread bench_tree.cpp block.cpp hash_simd.cpp
+*  (2) Traversal output is discarded, but block formatting is still timed.
+*
+*************************************************************************
+* Change Log:
+*   10/16/2026: Initial release. JME
+*   10/16/2026: Added AVL tree. JME
+*   10/16/2026: Added frozen tree lookups. JME
+*   10/17/2026: Added compact block tree. JME
+*   10/17/2026: Added traversal comparison. JME
+*   10/17/2026: Added block index lookups. JME
+*   10/17/2026: Added bulk load and merge. JME
+*   10/17/2026: Bulk load and merge checked against add/insertUnique. JME
+*   10/17/2026: Finds reported per second, pool trees do LOOKUPS finds. JME
+*   10/17/2026: Chain walk must visit every block, even with repeated hashes. JME
+*************************************************************************/
+#include <algorithm> // sort, equal
+#include <chrono>    // timing
+#include <cstdlib>   // strtoul
+#include <iomanip>   // manipulators
+#include <iostream>  // cout
+#include <memory>    // shared pointers
+#include <random>    // mt19937
+#include <string>    // hashes
+#include <unordered_map> // index comparison
+#include <vector>    // blocks
+
+#include "block.h"
+#include "block_index.h"
+#include "compact_block.h"
+#include "tree.h"
+
+using namespace myBlock;
+using namespace myTree;
+using namespace myIndex;
+
+// Default number of blocks.
+constexpr unsigned long DEFAULT_BLOCKS = 1000000;
+// Number of find calls timed in shared pointer tree (searches whole tree).
+constexpr unsigned long SHARED_FINDS = 20;
+// Fixed seed for random nonces.
+constexpr unsigned int SEED = 269;
+// Number of random finds timed per pool tree, and lookups per index.
+constexpr unsigned long LOOKUPS = 1000000;
+// Blocks (and range of their nonces) in bulk load stability check.
+constexpr std::size_t STABLE_BLOCKS = 2 * PARALLEL_SORT_SIZE;
+constexpr unsigned long STABLE_NONCES = 1000;
+// Threads used to check parallel sort, whatever the core count.
+constexpr std::size_t SORT_THREADS = 5;
+
+// Original tree layout: shared pointer nodes, recursive operations.
+template <class T>
+class SharedTree
+{
+	struct Node
+	{
+		T data;
+		std::shared_ptr<Node> left;
+		std::shared_ptr<Node> right;
+
+		explicit Node(T d) : data(d), left(nullptr), right(nullptr) { }
+	};
+
+	std::shared_ptr<Node> root;
+
+	void add(std::shared_ptr<Node> &node, T &data)
+	{
+		if (!node)
+			node = std::make_shared<Node>(data);
+		else
+			data < node->data ? add(node->left, data) : add(node->right, data);
+	}
+
+	bool find(std::shared_ptr<Node> node, T &data) const
+	{
+		if (!node)
+			return false;
+		if (node->data == data)
+			return true;
+		return find(node->left, data) || find(node->right, data);
+	}
+
+	void inOrder(const std::shared_ptr<Node> node) const
+	{
+		if (node->left)
+			inOrder(node->left);
+		std::cout << node->data;
+		if (node->right)
+			inOrder(node->right);
+	}
+
+public:
+	void add(T data) { add(root, data); }
+	bool find(T data) const { return find(root, data); }
+	void inOrder() const { if (root) inOrder(root); }
+	void clear() { root.reset(); }
+};
+
+// Time a function, returns seconds.
+template <class Func>
+static double timeIt(Func f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+// Time insert, random finds (finds/s), traversal and clear of a tree.
+template <class TreeType, class T>
+static void benchTree(const char* name, const std::vector<T>& blocks, unsigned long finds)
+{
+	TreeType tree;
+	std::mt19937 mt(SEED + 4);
+	std::vector<std::size_t> keys;
+	std::size_t found = 0;
+
+	for (unsigned long i = 0; i < finds; i++)
+		keys.push_back(mt() % blocks.size());
+
+	double tAdd = timeIt([&]() { for (auto& b : blocks) tree.add(b); });
+	double tFind = timeIt([&]() { for (std::size_t k : keys) found += tree.find(blocks[k]); });
+
+	std::streambuf* coutBuf = std::cout.rdbuf(nullptr);
+	double tInOrder = timeIt([&]() { tree.inOrder(); });
+	std::cout.rdbuf(coutBuf);
+
+	double tClear = timeIt([&]() { tree.clear(); });
+
+	std::cout << std::setw(8) << name << std::fixed << std::setprecision(3) << std::setw(10) << tAdd
+		<< std::setprecision(0) << std::setw(12) << finds / tFind << std::setprecision(3)
+		<< std::setw(10) << tInOrder << std::setw(10) << tClear << "  (" << finds << " finds)"
+		<< (found == finds ? "" : "  (find failed)") << "\n";
+}
+
+// Time lookups, returns lookups/s.
+template <class Find>
+static double lookupRate(const char* name, const std::vector<unsigned long>& keys, Find find)
+{
+	std::size_t found = 0;
+	double t = timeIt([&]() { for (auto k : keys) found += find(k); });
+
+	std::cout << std::setw(14) << name << std::setw(14) << std::setprecision(0) << LOOKUPS / t
+		<< (found == keys.size() ? "" : "  (lookup failed)") << "\n";
+	return LOOKUPS / t;
+}
+
+// Time random lookups in pointer trees and frozen snapshot.
+static void benchLookups(const std::vector<Block>& blocks)
+{
+	std::mt19937 mt(SEED + 1);
+	std::vector<unsigned long> nonces, ids;
+	Tree<Block> tree;
+	Tree<Block, AVL> avl;
+
+	for (auto& b : blocks)
+	{
+		tree.add(b);
+		avl.add(b);
+	}
+	for (unsigned long i = 0; i < LOOKUPS; i++)
+	{
+		const Block& b = blocks[mt() % blocks.size()];
+		nonces.push_back(b.getNonce());
+		ids.push_back(b.getID());
+	}
+
+	Block probe;
+	auto frozen = avl.freeze([](const Block& b) { return b.getNonce(); });
+	auto byId = frozen.index([](const Block& b) { return b.getID(); });
+
+	std::cout << "\n" << LOOKUPS << " random lookups (lookups/s):\n";
+	lookupRate("tree nonce", nonces, [&](unsigned long n) { probe.setNonce(n); return tree.find(probe); });
+	lookupRate("avl nonce", nonces, [&](unsigned long n) { probe.setNonce(n); return avl.find(probe); });
+	lookupRate("frozen nonce", nonces, [&](unsigned long n) { return frozen.find(n) != nullptr; });
+	lookupRate("frozen id", ids, [&](unsigned long id) { std::size_t slot; return byId.find(id, slot) && frozen.at(slot).getID() == id; });
+}
+
+// Time in-order traversal printing each block, against visiting each block
+// (summing nonces) with a visitor and with iterators.
+static void benchTraversal(const std::vector<Block>& blocks)
+{
+	Tree<Block, AVL> tree;
+	unsigned long long visitSum = 0, iterSum = 0;
+
+	for (auto& b : blocks)
+		tree.add(b);
+
+	std::streambuf* coutBuf = std::cout.rdbuf(nullptr);
+	double tPrint = timeIt([&]() { tree.inOrder(); });
+	std::cout.rdbuf(coutBuf);
+	double tVisit = timeIt([&]() { tree.inOrder([&](const Block& b) { visitSum += b.getNonce(); }); });
+	double tIter = timeIt([&]() { for (const Block& b : tree) iterSum += b.getNonce(); });
+
+	std::cout << "\nIn-order traversal (blocks/s):\n" << std::setprecision(0)
+		<< std::setw(14) << "print" << std::setw(14) << blocks.size() / tPrint << "\n"
+		<< std::setw(14) << "visitor" << std::setw(14) << blocks.size() / tVisit << "\n"
+		<< std::setw(14) << "iterator" << std::setw(14) << blocks.size() / tIter
+		<< (visitSum == iterSum ? "" : "  (sum mismatch)") << "\n";
+}
+
+// Time building a tree one add at a time against bulkLoad(), and merging two
+// bulk loaded halves, for random and sorted blocks. Skips adding sorted 
+// blocks to the unbalanced tree (quadratic).
+static void benchBulk(const std::vector<Block>& blocks)
+{
+	std::vector<Block> sorted(blocks);
+	const std::vector<Block>* inputs[] = { &blocks, &sorted };
+
+	std::sort(sorted.begin(), sorted.end());
+
+	std::cout << "\nBuild tree (seconds, height):\n"
+		<< "  build        random         sorted\n";
+
+	auto row = [&](const char* name, auto build)
+	{
+		std::cout << std::setw(7) << name;
+		for (const std::vector<Block>* input : inputs)
+		{
+			int height = -1;
+			double t = timeIt([&]() { height = build(*input); });
+
+			if (height < 0)
+				std::cout << std::setw(15) << "-";
+			else
+				std::cout << std::setw(10) << std::setprecision(3) << t << std::setw(5) << height;
+		}
+		std::cout << "\n";
+	};
+
+	row("add", [&](const std::vector<Block>& in)
+	{
+		if (&in == &sorted)
+			return -1;
+		Tree<Block> tree;
+		for (auto& b : in)
+			tree.add(b);
+		return tree.getHeight();
+	});
+	row("avl", [](const std::vector<Block>& in)
+	{
+		Tree<Block, AVL> tree;
+		for (auto& b : in)
+			tree.add(b);
+		return tree.getHeight();
+	});
+	row("bulk", [](const std::vector<Block>& in)
+	{
+		Tree<Block> tree;
+		tree.bulkLoad(in.begin(), in.end());
+		return tree.getHeight();
+	});
+	row("merge", [](const std::vector<Block>& in)
+	{
+		Tree<Block> tree, other;
+		tree.bulkLoad(in.begin(), in.begin() + in.size() / 2);
+		other.bulkLoad(in.begin() + in.size() / 2, in.end());
+		tree.merge(other);
+		return tree.getHeight();
+	});
+}
+
+// True if trees hold the same blocks in the same order. Ids are unique, so
+// this also compares the order of blocks with equal nonces.
+template <class TreeA, class TreeB>
+static bool sameBlocks(const TreeA& a, const TreeB& b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), b.end(),
+		[](const Block& x, const Block& y) { return x.getID() == y.getID() && x.getNonce() == y.getNonce(); });
+}
+
+// Check bulkLoad() and merge() of bulk loaded halves match an AVL tree built
+// one add() (or insertUnique()) at a time, for random, sorted and heavily
+// duplicated nonces. Also checks the parallel sort against std::stable_sort.
+static bool checkBulk(const std::vector<Block>& blocks)
+{
+	std::mt19937 mt(SEED + 3);
+	std::vector<Block> sorted(blocks), duplicates;
+
+	std::sort(sorted.begin(), sorted.end());
+	duplicates.reserve(STABLE_BLOCKS);
+	for (std::size_t i = 0; i < STABLE_BLOCKS; i++)
+		duplicates.emplace_back(i, "0", mt() % STABLE_NONCES);
+
+	const struct { const char* name; const std::vector<Block>* blocks; } inputs[] = {
+		{ "random", &blocks }, { "sorted", &sorted }, { "duplicate", &duplicates } };
+
+	for (const auto& input : inputs)
+		for (bool unique : { false, true })
+		{
+			const std::vector<Block>& in = *input.blocks;
+			const auto half = in.begin() + in.size() / 2;
+			Tree<Block, AVL> expected;
+			Tree<Block> bulk, merged, other;
+
+			for (auto& b : in)
+			{
+				if (unique)
+					expected.insertUnique(b);
+				else
+					expected.add(b);
+			}
+			bulk.bulkLoad(in.begin(), in.end(), unique);
+			merged.bulkLoad(in.begin(), half, unique);
+			other.bulkLoad(half, in.end(), unique);
+			merged.merge(other, unique);
+
+			if (!sameBlocks(expected, bulk) || !sameBlocks(expected, merged))
+			{
+				std::cout << "Bulk load mismatch (" << input.name << (unique ? ", unique" : "") << ")\n";
+				return false;
+			}
+		}
+
+	std::vector<Block> parallel(duplicates), serial(duplicates);
+	parallelStableSort(parallel, SORT_THREADS);
+	std::stable_sort(serial.begin(), serial.end());
+	if (!std::equal(parallel.begin(), parallel.end(), serial.begin(), [](const Block& x, const Block& y) { return x.getID() == y.getID(); }))
+	{
+		std::cout << "Parallel sort is not stable\n";
+		return false;
+	}
+
+	std::cout << "Bulk load and merge match add/insertUnique, " << SORT_THREADS << " thread sort is stable.\n";
+	return true;
+}
+
+// Time id and hash lookups and chain walk in block index, against unordered
+// maps. Returns false if the walk from the tip doesn't reach every block.
+static bool benchIndex(const std::vector<Block>& blocks)
+{
+	std::mt19937 mt(SEED + 2);
+	std::vector<Block> chain;
+	std::vector<std::string> hashes;
+	std::vector<unsigned long> ids;
+	std::string hash("0");
+
+	// Link blocks into a chain, so hashes and previous hashes are real.
+	chain.reserve(blocks.size());
+	hashes.reserve(blocks.size());
+	for (auto& b : blocks)
+	{
+		Block c(b.getID(), hash, b.getNonce());
+
+		hash = digestString(Block::calcHash(hash, b.getNonce()));
+		c.setHash(hash);
+		chain.push_back(c);
+		hashes.push_back(hash);
+	}
+	for (unsigned long i = 0; i < LOOKUPS; i++)
+		ids.push_back(mt() % chain.size());
+
+	BlockIndex<Block> index;
+	std::unordered_map<unsigned long, std::size_t> mapId;
+	std::unordered_map<std::string, std::size_t> mapHash;
+
+	double tIndex = timeIt([&]() { for (auto& b : chain) index.add(b); });
+	double tMap = timeIt([&]()
+	{
+		for (std::size_t i = 0; i < chain.size(); i++)
+		{
+			mapId.emplace(chain[i].getID(), i);
+			mapHash.emplace(hashes[i], i);
+		}
+	});
+
+	std::cout << "\nBlock index of " << chain.size() << " blocks, add (blocks/s): index " << std::setprecision(0) << chain.size() / tIndex
+		<< ", unordered " << chain.size() / tMap << "\n"
+		<< "  id   " << index.idStats() << "\n  hash " << index.hashStats() << "\n  link " << index.linkStats() << "\n"
+		<< LOOKUPS << " random lookups (lookups/s):\n";
+	lookupRate("index id", ids, [&](unsigned long id) { const Block* b = index.byId(id); return b && b->getID() == id; });
+	lookupRate("unordered id", ids, [&](unsigned long id) { auto i = mapId.find(id); return i != mapId.end() && chain[i->second].getID() == id; });
+	lookupRate("index hash", ids, [&](unsigned long id) { const Block* b = index.byHash(hashes[id]); return b && b->getHash() == hashes[id]; });
+	lookupRate("unordered hash", ids, [&](unsigned long id) { auto i = mapHash.find(hashes[id]); return i != mapHash.end() && chain[i->second].getHash() == hashes[id]; });
+
+	// Walk chain from tip, by previous hash. A 32-bit hash repeats in a long
+	// chain, the walk must still visit every block.
+	const std::size_t repeats = chain.size() - mapHash.size();
+	std::size_t walked = 0;
+	double tWalk = timeIt([&]() { walked = index.walk(chain.back(), [](const Block&) { }); });
+	std::cout << std::setw(14) << "walk" << std::setw(14) << walked / tWalk << "  blocks/s, " << walked << " blocks";
+	if (repeats)
+		std::cout << " (" << repeats << " repeated hashes)";
+	if (walked != chain.size())
+	{
+		std::cout << "  (walk failed)\n";
+		return false;
+	}
+	std::cout << "\n";
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : DEFAULT_BLOCKS;
+	std::mt19937 mt(SEED);
+	std::vector<Block> blocks;
+
+	blocks.reserve(count);
+	for (unsigned long i = 0; i < count; i++)
+		blocks.emplace_back(i, "0", mt());
+
+	std::cout << "Tree of " << count << " blocks (seconds, finds/s):\n"
+		<< "  layout       add      find/s   inOrder     clear\n";
+	benchTree<SharedTree<Block>>("shared", blocks, SHARED_FINDS);
+	benchTree<Tree<Block>>("pool", blocks, LOOKUPS);
+	benchTree<Tree<Block, AVL>>("avl", blocks, LOOKUPS);
+
+	std::vector<CompactBlock> compact(blocks.begin(), blocks.end());
+	benchTree<Tree<CompactBlock, AVL>>("compact", compact, LOOKUPS);
+	std::cout << "  block size " << sizeof(Block) << " bytes (plus strings), compact block " << sizeof(CompactBlock) << " bytes\n";
+	benchLookups(blocks);
+	benchTraversal(blocks);
+	benchBulk(blocks);
+	if (!checkBulk(blocks))
+		return EXIT_FAILURE;
+	if (!benchIndex(blocks))
+		return EXIT_FAILURE;
+
+	return 0;
+}
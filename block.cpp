@@ -1,116 +1,368 @@
-/*************************************************************************
-* Title: Block Class
-* File: block.cpp
-* Author: James Eli
-* Date: 9/21/2018
-*
-* Blockchain Block Class Definition.
-*
-* Notes:
-*  (1) Blockchain information researched in "Mastering Blockchain",
-*      2nd Edition, Imram Bashir.
-*  (2) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0
-*  (3) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*   09/21/2018: Initial release. JME
-*   10/07/2018: Added isBlockValid.  JME
-*   11/01/2018: Changed isBlockValid stoi to stoul.  JME
-*   11/09/2018: Added comparison operators. JME
-*   11/09/2018: Moved DIFFICULTY declaration to main.cpp. JME
-*   11/09/2018: Updated << operator per assignment directions. JME
-*   11/09/2018: Changed mineBlock() loop. JME
-*   11/09/2018: Replaced STL hash with user selectable versions.  JME
-*   11/11/2018: Removed unused ctors.  JME
-*************************************************************************/
-#include "block.h"
-#include "hash_funcs.h"
-
-using namespace myBlock;
-
-// All but hash ctor.
-Block::Block(
-	const unsigned long i, // id
-	std::string ph,        // previous hash
-	const unsigned long n  // nonce
-	) : id(i), nonce(n), previousHash(ph)
-{
-	setTimeID(timeStamp());
-	setHash(std::to_string(calcHash()));
-}
-
-// Additional block ctor.
-Block::Block(unsigned long i)
-{
-	setTimeID(timeStamp());
-	setID(i);
-	setNonce(0);
-	setPreviousHash("0");
-	setHash(std::to_string(calcHash()));
-}
-
-// Get/set id.
-unsigned long Block::getID() const { return id; }
-void Block::setID(unsigned long i) { id = i; }
-
-// Get/set nonce.
-unsigned long Block::getNonce() const { return nonce; }
-void Block::setNonce(unsigned long n) { this->nonce = n; }
-
-// Get/set time stamp.
-time_t Block::getTimeID() const { return timeId; }
-void Block::setTimeID(time_t ts) { this->timeId = ts; }
-
-// Get/set hash.
-std::string Block::getHash() const { return hash; }
-void Block::setHash(std::string h) { hash = h; }
-
-// Get/set previous hash.
-std::string Block::getPreviousHash() const { return previousHash; }
-void Block::setPreviousHash(std::string ph) { previousHash = ph; }
-
-// Calculate appropraite hash of "prevHash" + "nonce". See hash_funcs.h file for options.
-inline uint32_t Block::calcHash() 
-{
-	// Use FNV1-a hash algorithm.
-	Hash<> fnv1a; // Hash<stl_32> to use STL library hash.
-
-	return fnv1a.hashString(previousHash + std::to_string(nonce)); 
-}
-
-// Block miner.
-void Block::MineBlock(unsigned int difficulty)
-{
-	// Build string with difficulty number of leading zeros.
-	std::string sDifficulty(difficulty, '0');
-
-	uint32_t h;                // Temp holder of 32-bit hash value.
-	std::stringstream hexHash; // Hash value formatted as hex string.
-
-	// Loop (incrementing nonce) until hash meets difficulty level.
-	for (; hexHash.str().substr(0, difficulty) != sDifficulty; nonce++)
-	{
-		// Hash "prevhash" + "nonce".
-		h = calcHash();
-		// Push hash through hex manipulator.
-		hexHash.str("");
-		hexHash << std::hex << std::setfill('0') << std::setw(8) << h;
-	}
-
-	// Save the hash as string.
-	hash = std::to_string(h);
-
-//#ifndef NDEBUG
-	std::cout << ".";
-//#endif
-}
-
-// Use current time as timestamp (milliseconds since Unix Epoch).
-time_t Block::timeStamp() { return std::time(0); }
-
-// Validate stored hash against calculated hash to prevent forgery.
-bool Block::isHashValid() { return calcHash() == static_cast<unsigned long>(std::stoul(getHash())); }
+/*************************************************************************
+* Title: Block Class
+* File: block.cpp
+* Author: James Eli
+* Date: 9/21/2018
+*
+* Blockchain Block Class Definition.
+*
+* Notes:
+*  (1) Blockchain information researched in "Mastering Blockchain",
+*      2nd Edition, Imram Bashir.
+*  (2) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0
+*  (3) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*   09/21/2018: Initial release. JME
+*   10/07/2018: Added isBlockValid.  JME
+*   11/01/2018: Changed isBlockValid stoi to stoul.  JME
+*   11/09/2018: Added comparison operators. JME
+*   11/09/2018: Moved DIFFICULTY declaration to main.cpp. JME
+*   11/09/2018: Updated << operator per assignment directions. JME
+*   11/09/2018: Changed mineBlock() loop. JME
+*   11/09/2018: Replaced STL hash with user selectable versions.  JME
+*   11/11/2018: Removed unused ctors.  JME
+*   10/16/2026: Added multi-threaded mineBlock(). Nonce now left at the
+*               winning value (was one past it).  JME
+*   10/16/2026: Allocation free hashing inside mining loop.  JME
+*   10/16/2026: Reuse previous hash midstate for each nonce.  JME
+*   10/16/2026: Hash 8 nonces at once using SIMD kernels.  JME
+*   10/17/2026: Moved nonce search into public findNonce().  JME
+*   10/17/2026: findNonce()/calcHash() by hash function id.  JME
+*   10/17/2026: MineBlock() no longer prints, records stats (see stats.h).
+*               JME
+*   10/17/2026: Block is a template on hasher (BasicBlock<Hasher>),
+*               explicitly instantiated for each hasher in hashers.h.  JME
+*   10/17/2026: SHA-256 and double SHA-256 mine with multi-lane kernels.
+*               JME
+*   10/17/2026: Added findNonceIn().  JME
+*************************************************************************/
+#include <algorithm>  // max
+#include <atomic>     // atomic nonce counters
+#include <charconv>   // to_chars
+#include <climits>    // ULONG_MAX
+#include <limits>     // digits10
+#include <stdexcept>  // out of range, invalid argument
+#include <type_traits> // same digest
+#include <vector>     // worker threads
+#include "block.h"
+#include "hash_funcs.h"
+#include "hash_simd.h"
+#include "stats.h"
+
+using namespace myBlock;
+
+// Number of nonces a mining thread claims at a time.
+constexpr unsigned long MINING_CHUNK_SIZE = 1024;
+// Maximum number of decimal digits in a nonce.
+constexpr std::size_t MAX_NONCE_DIGITS = std::numeric_limits<unsigned long>::digits10 + 1;
+
+// Multi-lane kernel of hasher, if any (see hash_simd.h).
+template <class Hasher>
+struct HasherLanes { static constexpr bool available = false; };
+
+template <HashFunc hf, HashId hid>
+struct HasherLanes<FuncHasher<hf, hid>> : LaneKernel<hf> { };
+
+template <>
+struct HasherLanes<Sha256>
+{
+	static constexpr bool available = true;
+	static void hash(const Sha256::State& s, const LaneMessages& m, Digest256 out[HASH_LANES]) { sha256_lanes(s, m, out); }
+};
+
+template <>
+struct HasherLanes<Sha256d>
+{
+	static constexpr bool available = true;
+	static void hash(const Sha256d::State& s, const LaneMessages& m, Digest256 out[HASH_LANES]) { sha256_lanes(s.inner, m, out, true); }
+};
+
+// "prevHash" + "nonce" message. The previous hash is hashed once, and its
+// hash state is reused so only the nonce digits are hashed for each nonce.
+template <class Hasher>
+class Message
+{
+	typedef typename Hasher::digest_type Digest;
+	typename Hasher::State prefix; // Hash state after previous hash.
+
+public:
+	explicit Message(std::string_view previousHash) { prefix.update(previousHash); }
+
+	// Hash "prevHash" + "nonce".
+	Digest hash(unsigned long nonce) const
+	{
+		char digits[MAX_NONCE_DIGITS];
+		char *end = std::to_chars(digits, digits + MAX_NONCE_DIGITS, nonce).ptr;
+		typename Hasher::State state(prefix);
+
+		state.update(std::string_view(digits, end - digits));
+		return state.finalize();
+	}
+
+	// Find lowest nonce in [first, first + count) with hash meeting difficulty
+	// target. Hashes HASH_LANES nonces at once if hasher has a multi-lane
+	// kernel (see hash_simd.h).
+	bool search(unsigned long first, unsigned long count, const DifficultyTarget<Digest>& target, unsigned long& found) const
+	{
+		if constexpr (HasherLanes<Hasher>::available)
+		{
+			NonceLanes lanes(first);
+			Digest h[HASH_LANES];
+
+			for (unsigned long i = 0; i < count; i += HASH_LANES, lanes.advance())
+			{
+				HasherLanes<Hasher>::hash(prefix, lanes, h);
+				for (std::size_t lane = 0; lane < HASH_LANES && i + lane < count; lane++)
+					if (target.met(h[lane]))
+					{
+						found = lanes.nonce(lane);
+						STATS_COUNT(HASHES, found - first + 1);
+						return true;
+					}
+			}
+		}
+		else
+		{
+			for (unsigned long n = first; n < first + count; n++)
+				if (target.met(hash(n)))
+				{
+					found = n;
+					STATS_COUNT(HASHES, n - first + 1);
+					return true;
+				}
+		}
+
+		STATS_COUNT(HASHES, count);
+		return false;
+	}
+};
+
+// Call f(Hasher()) if hasher has the Digest type, else throw.
+template <class Hasher, class Digest, class Result, class F>
+static Result callHasher(F f)
+{
+	if constexpr (std::is_same<typename Hasher::digest_type, Digest>::value)
+		return f(Hasher());
+	else
+		throw std::invalid_argument("hash function digest differs from block digest");
+}
+
+// Call f(Hasher()) with hasher identified by hid.
+template <class Digest, class Result, class F>
+static Result withHasher(HashId hid, F f)
+{
+	switch (hid)
+	{
+	case HashId::STL_32:   return callHasher<Stl32, Digest, Result>(f);
+	case HashId::FNV1A_32: return callHasher<Fnv1a32, Digest, Result>(f);
+	case HashId::CRC_32:   return callHasher<Crc32, Digest, Result>(f);
+	case HashId::SDBM_32:  return callHasher<Sdbm32, Digest, Result>(f);
+	case HashId::FNV1A_64: return callHasher<Fnv1a64, Digest, Result>(f);
+	case HashId::XXH64:    return callHasher<XxHash64, Digest, Result>(f);
+	case HashId::SHA256:   return callHasher<Sha256, Digest, Result>(f);
+	case HashId::SHA256D:  return callHasher<Sha256d, Digest, Result>(f);
+	default:               throw std::invalid_argument("unknown hash function");
+	}
+}
+
+// All but hash ctor.
+template <class Hasher>
+BasicBlock<Hasher>::BasicBlock(
+	const unsigned long i, // id
+	std::string ph,        // previous hash
+	const unsigned long n  // nonce
+	) : id(i), nonce(n), previousHash(ph)
+{
+	setTimeID(timeStamp());
+	setHash(digestString(calcHash()));
+}
+
+// Additional block ctor.
+template <class Hasher>
+BasicBlock<Hasher>::BasicBlock(unsigned long i)
+{
+	setTimeID(timeStamp());
+	setID(i);
+	setNonce(0);
+	setPreviousHash("0");
+	setHash(digestString(calcHash()));
+}
+
+// Get/set id.
+template <class Hasher>
+unsigned long BasicBlock<Hasher>::getID() const { return id; }
+template <class Hasher>
+void BasicBlock<Hasher>::setID(unsigned long i) { id = i; }
+
+// Get/set nonce.
+template <class Hasher>
+unsigned long BasicBlock<Hasher>::getNonce() const { return nonce; }
+template <class Hasher>
+void BasicBlock<Hasher>::setNonce(unsigned long n) { this->nonce = n; }
+
+// Get/set time stamp.
+template <class Hasher>
+time_t BasicBlock<Hasher>::getTimeID() const { return timeId; }
+template <class Hasher>
+void BasicBlock<Hasher>::setTimeID(time_t ts) { this->timeId = ts; }
+
+// Get/set hash.
+template <class Hasher>
+std::string BasicBlock<Hasher>::getHash() const { return hash; }
+template <class Hasher>
+void BasicBlock<Hasher>::setHash(std::string h) { hash = h; }
+
+// Get/set previous hash.
+template <class Hasher>
+std::string BasicBlock<Hasher>::getPreviousHash() const { return previousHash; }
+template <class Hasher>
+void BasicBlock<Hasher>::setPreviousHash(std::string ph) { previousHash = ph; }
+
+// Calculate appropraite hash of "prevHash" + "nonce".
+template <class Hasher>
+inline typename Hasher::digest_type BasicBlock<Hasher>::calcHash() const { return calcHash(nonce); }
+
+template <class Hasher>
+inline typename Hasher::digest_type BasicBlock<Hasher>::calcHash(unsigned long n) const { return Message<Hasher>(previousHash).hash(n); }
+
+// Find lowest nonce (from start) whose hash meets difficulty level. With
+// multiple threads, threads claim chunks of nonces in increasing order. A 
+// thread stops at its first winning nonce, or once its next chunk starts 
+// past the best winner found so far. Every chunk below the winner is 
+// therefore searched completely, and the result is always the lowest valid 
+// nonce (same as the single-threaded search).
+template <class Hasher>
+static unsigned long searchNonce(const std::string& previousHash, unsigned long start,
+	const DifficultyTarget<typename Hasher::digest_type>& target, unsigned int threads)
+{
+	typedef Message<Hasher> SearchMessage;
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+
+	if (threads == 1)
+	{
+		SearchMessage message(previousHash);
+		unsigned long n = start;
+
+		// Search (increasing) chunks of nonces until hash meets difficulty level.
+		while (!message.search(n, MINING_CHUNK_SIZE, target, n))
+			n += MINING_CHUNK_SIZE;
+
+		return n;
+	}
+
+	std::atomic<unsigned long> next(0);         // Offset of next unclaimed chunk.
+	std::atomic<unsigned long> best(ULONG_MAX); // Offset of lowest winning nonce.
+
+	auto worker = [&]()
+	{
+		SearchMessage message(previousHash);
+		unsigned long found;
+
+		for (;;)
+		{
+			unsigned long base = next.fetch_add(MINING_CHUNK_SIZE, std::memory_order_relaxed);
+
+			if (base > best.load(std::memory_order_relaxed))
+				return;
+
+			if (message.search(start + base, MINING_CHUNK_SIZE, target, found))
+			{
+				// Keep the lowest winner.
+				unsigned long i = found - start;
+				unsigned long current = best.load(std::memory_order_relaxed);
+				while (i < current && !best.compare_exchange_weak(current, i, std::memory_order_relaxed))
+					;
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int t = 0; t < threads; t++)
+		pool.emplace_back(worker);
+	for (auto& t : pool)
+		t.join();
+
+	return start + best.load();
+}
+
+template <class Hasher>
+unsigned long BasicBlock<Hasher>::findNonce(const std::string& previousHash, unsigned long start, unsigned int difficulty, unsigned int threads)
+{
+	return searchNonce<Hasher>(previousHash, start, DifficultyTarget<digest_type>(difficulty), threads);
+}
+
+// Search one range of nonces.
+template <class Hasher>
+bool BasicBlock<Hasher>::findNonceIn(const std::string& previousHash, unsigned long first, unsigned long count, unsigned int difficulty, unsigned long& found)
+{
+	return Message<Hasher>(previousHash).search(first, count, DifficultyTarget<digest_type>(difficulty), found);
+}
+
+// Same search using hash function id (ex. for benchmarks).
+template <class Hasher>
+unsigned long BasicBlock<Hasher>::findNonce(HashId hid, const std::string& previousHash, unsigned long start, unsigned int difficulty, unsigned int threads)
+{
+	const DifficultyTarget<digest_type> target(difficulty);
+
+	return withHasher<digest_type, unsigned long>(hid, [&](auto h) { return searchNonce<decltype(h)>(previousHash, start, target, threads); });
+}
+
+// Hash "previousHash" + "nonce".
+template <class Hasher>
+typename Hasher::digest_type BasicBlock<Hasher>::calcHash(const std::string& previousHash, unsigned long nonce) 
+{ 
+	return Message<Hasher>(previousHash).hash(nonce); 
+}
+
+// Same hash using hash function id.
+template <class Hasher>
+typename Hasher::digest_type BasicBlock<Hasher>::calcHash(HashId hid, const std::string& previousHash, unsigned long nonce)
+{
+	return withHasher<digest_type, digest_type>(hid, [&](auto h) { return Message<decltype(h)>(previousHash).hash(nonce); });
+}
+
+// Hash meets difficulty level.
+template <class Hasher>
+bool BasicBlock<Hasher>::meetsDifficulty(const digest_type& h, unsigned int difficulty) { return DifficultyTarget<digest_type>(difficulty).met(h); }
+
+// Block miner.
+template <class Hasher>
+void BasicBlock<Hasher>::MineBlock(unsigned int difficulty) { MineBlock(difficulty, 1); }
+
+// Multi-threaded block miner.
+template <class Hasher>
+void BasicBlock<Hasher>::MineBlock(unsigned int difficulty, unsigned int threads)
+{
+	STATS_BLOCK_START(nonce);
+	nonce = findNonce(previousHash, nonce, difficulty, threads);
+	STATS_BLOCK_END(id, nonce, threads);
+
+	// Save the hash as string.
+	hash = digestString(calcHash());
+}
+
+// Use current time as timestamp (milliseconds since Unix Epoch).
+template <class Hasher>
+time_t BasicBlock<Hasher>::timeStamp() { return std::time(0); }
+
+// Validate stored hash against calculated hash to prevent forgery.
+template <class Hasher>
+bool BasicBlock<Hasher>::isHashValid() const { return digestString(calcHash()) == getHash(); }
+
+// Blocks of each hasher (see hashers.h).
+template class myBlock::BasicBlock<Stl32>;
+template class myBlock::BasicBlock<Fnv1a32>;
+template class myBlock::BasicBlock<Crc32>;
+template class myBlock::BasicBlock<Sdbm32>;
+template class myBlock::BasicBlock<Fnv1a64>;
+template class myBlock::BasicBlock<XxHash64>;
+template class myBlock::BasicBlock<Sha256>;
+template class myBlock::BasicBlock<Sha256d>;
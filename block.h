@@ -1,123 +1,177 @@
-/*************************************************************************
-* Title: Block class
-* File: block.h
-* Author: James Eli
-* Date: 9/21/2018
-*
-* Blockchain Block Class Declaration.
-*
-* Declares a block class containing an ID, Time Stamp, Hash, Previous Hash
-* and Nonce members. All members are private. Includes accessors (get/set)
-* for all members. Provides appropriate ctors for genesis block creation
-* and follow-on chain blocks. Includes a formatted print function.
-*
-* Notes:
-*  (1) Could not achieve consistent results when using the STL x64 hash 
-*      function. The STL hash returns std:size_t (32-bits on x86, and 
-*      64-bits on x64). The STL hash exihibtted sluggish performance and
-*      suspect nonce values). So, the STL library hash function and 2 
-*      alternative functions were researched and provided. See comments 
-*      inside the hash_funcs.h file for further information.
-*  (2) Blockchain information researched in "Mastering Blockchain",
-*      2nd Edition, Imram Bashir.
-*  (3) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0
-*  (4) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*   09/21/2018: Initial release. JME
-*   11/09/2018: Added comparison operators. JME
-*   11/09/2018: Moved DIFFICULTY declaration to main.cpp. JME
-*   11/09/2018: Updated << operator per assignment directions. JME
-*   11/09/2018: Changed debug print inside mineBlock(). JME
-*   11/09/2018: Replaced STL hash with user selectable versions.  JME
-*   11/09/2018: Cleaned up unused ctors/parameters.  JME
-*************************************************************************/
-#ifndef _BLOCK_H_
-#define _BLOCK_H_
-
-#include <cstdint>    // uint32_t
-#include <iostream>   // cout
-#include <iomanip>    // hex conversion manipulators
-#include <sstream>    // string conversion
-#include <string>     // c++ strings
-#include <ctime>      // time()
-
-namespace myBlock {
-
-	class Block
-	{
-	public:
-		// Default ctor.
-		Block() = default;
-		// Empty block ctor (id).
-		explicit Block(const unsigned long);
-		// All members except hash ctor.
-		Block(const unsigned long, /* id */
-			std::string,           /* previous hash */
-			const unsigned long    /* nonce */
-		);
-
-		// Dtor.
-		~Block() = default;
-
-		// Accessor functions for id number.
-		void setID(const unsigned long);
-		unsigned long getID() const;
-
-		// Accessor functions for hash.
-		void setHash(std::string);
-		std::string getHash() const;
-
-		// Accessor functions for previous hash.
-		void setPreviousHash(std::string);
-		std::string getPreviousHash() const;
-
-		// Accessor functions for nonce.
-		void setNonce(unsigned long);
-		unsigned long getNonce() const;
-
-		// Accessor functions for time stamp.
-		void setTimeID(time_t);
-		time_t getTimeID() const;
-
-		// Mine blocks.
-		void MineBlock(unsigned int);
-
-		// Validate stored hash against calculated hash to prevent forgery.
-		bool isHashValid();
-
-		// Print formatted block data.
-		friend std::ostream& operator<< (std::ostream& os, const Block& b)
-		{
-			std::stringstream ss;
-
-			ss << std::setfill('0') << std::setw(sizeof(unsigned long) * 2) << std::hex << b.getHash();
-			return os << std::setfill(' ') << std::setw(2) << b.getID()
-				<< ":0x" << ss.str() << ":" << b.getNonce() << std::endl;
-		}
-
-		// Less than operator, only based upon comparison of block nonce!
-		bool operator< (Block rhs) { return (this->nonce < rhs.nonce); }
-		// Equality operator, only based upon comparison of block nonce!
-		bool operator== (Block rhs) { return (this->nonce == rhs.nonce); }
-
-	private:
-		// Private member data.
-		unsigned long id;         // Block identification number (id).
-		unsigned long nonce;      // Nonce, used in computing hash.
-		time_t timeId;            // Timestamp.
-		std::string hash;         // Hash of current block.
-		std::string previousHash; // Hash of previous block.
-
-		// Hash calculation.
-		inline uint32_t calcHash();
-
-		// Sets time stamp to now (seconds past Unix epoch).
-		static time_t timeStamp();
-	};
-}
-#endif
+/*************************************************************************
+* Title: Block class
+* File: block.h
+* Author: James Eli
+* Date: 9/21/2018
+*
+* Blockchain Block Class Declaration.
+*
+* Declares a block class containing an ID, Time Stamp, Hash, Previous Hash
+* and Nonce members. All members are private. Includes accessors (get/set)
+* for all members. Provides appropriate ctors for genesis block creation
+* and follow-on chain blocks. Includes a formatted print function.
+*
+* Notes:
+*  (1) Could not achieve consistent results when using the STL x64 hash 
+*      function. The STL hash returns std:size_t (32-bits on x86, and 
+*      64-bits on x64). The STL hash exihibtted sluggish performance and
+*      suspect nonce values). So, the STL library hash function and 2 
+*      alternative functions were researched and provided. See comments 
+*      inside the hash_funcs.h file for further information.
+*  (2) BasicBlock<Hasher> mines and hashes with a hasher from hashers.h,
+*      so the search loop is compiled for each hasher. Block uses
+*      BlockHasher (32-bit FNV-1a). Hash text is digestString() of the
+*      digest. Members are defined, and instantiated for each hasher, in
+*      block.cpp. Chains of any BasicBlock validate (chain_validate.h),
+*      but CompactBlock and chain files only hold Block (32-bit) digests,
+*      so blocks of other hashers can't be converted or saved.
+*  (3) Blockchain information researched in "Mastering Blockchain",
+*      2nd Edition, Imram Bashir.
+*  (4) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0
+*  (5) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*   09/21/2018: Initial release. JME
+*   11/09/2018: Added comparison operators. JME
+*   11/09/2018: Moved DIFFICULTY declaration to main.cpp. JME
+*   11/09/2018: Updated << operator per assignment directions. JME
+*   11/09/2018: Changed debug print inside mineBlock(). JME
+*   11/09/2018: Replaced STL hash with user selectable versions.  JME
+*   11/09/2018: Cleaned up unused ctors/parameters.  JME
+*   10/16/2026: Added multi-threaded MineBlock(difficulty, threads).  JME
+*   10/16/2026: Replaced hex string difficulty test with bit mask.  JME
+*   10/16/2026: Comparison operators are const and take references.  JME
+*   10/17/2026: Added static findNonce() and calcHash().  JME
+*   10/17/2026: Added hashId().  JME
+*   10/17/2026: Added meetsDifficulty(), isHashValid() is const.  JME
+*   10/17/2026: Added findNonce()/calcHash() by hash function id.  JME
+*   10/17/2026: Block is BasicBlock<Hasher>, parameterised on a hasher from
+*               hashers.h. Hashes are digest_type.  JME
+*   10/17/2026: Added findNonceIn() to search a range of nonces.  JME
+*   10/17/2026: Noted which hashers compact blocks and chain files hold.  JME
+*************************************************************************/
+#ifndef _BLOCK_H_
+#define _BLOCK_H_
+
+#include <cstdint>    // uint32_t
+#include <iostream>   // cout
+#include <iomanip>    // hex conversion manipulators
+#include <sstream>    // string conversion
+#include <string>     // c++ strings
+#include <ctime>      // time()
+#include <thread>     // hardware concurrency
+#include "hash_funcs.h"
+#include "hashers.h"
+
+namespace myBlock {
+
+	// Block hash function. See hashers.h file for options.
+	typedef Fnv1a32 BlockHasher; // Stl32 to use STL library hash.
+
+	template <class Hasher = BlockHasher>
+	class BasicBlock
+	{
+	public:
+		typedef Hasher hasher_type;
+		typedef typename Hasher::digest_type digest_type;
+
+		// Default ctor.
+		BasicBlock() = default;
+		// Empty block ctor (id).
+		explicit BasicBlock(const unsigned long);
+		// All members except hash ctor.
+		BasicBlock(const unsigned long, /* id */
+			std::string,           /* previous hash */
+			const unsigned long    /* nonce */
+		);
+
+		// Dtor.
+		~BasicBlock() = default;
+
+		// Accessor functions for id number.
+		void setID(const unsigned long);
+		unsigned long getID() const;
+
+		// Accessor functions for hash.
+		void setHash(std::string);
+		std::string getHash() const;
+
+		// Accessor functions for previous hash.
+		void setPreviousHash(std::string);
+		std::string getPreviousHash() const;
+
+		// Accessor functions for nonce.
+		void setNonce(unsigned long);
+		unsigned long getNonce() const;
+
+		// Accessor functions for time stamp.
+		void setTimeID(time_t);
+		time_t getTimeID() const;
+
+		// Mine blocks.
+		void MineBlock(unsigned int);
+		// Mine blocks using multiple threads (difficulty, thread count). A thread
+		// count of 0 uses all hardware threads, 1 is the same as MineBlock(difficulty).
+		void MineBlock(unsigned int, unsigned int);
+
+		// Validate stored hash against calculated hash to prevent forgery.
+		bool isHashValid() const;
+
+		// Lowest nonce (from start) with "previousHash" + "nonce" hash meeting
+		// difficulty (previous hash, start, difficulty, thread count).
+		static unsigned long findNonce(const std::string&, unsigned long, unsigned int, unsigned int = 1);
+		// Same, using hash function id instead of block hash function (hash id,
+		// previous hash, start, difficulty, thread count). The hash function
+		// must have the block digest type.
+		static unsigned long findNonce(HashId, const std::string&, unsigned long, unsigned int, unsigned int = 1);
+		// Lowest nonce in [first, first + count) meeting difficulty, false if none
+		// (previous hash, first, count, difficulty, nonce found). Lets callers
+		// split a search into ranges (ex. scheduler.h).
+		static bool findNonceIn(const std::string&, unsigned long, unsigned long, unsigned int, unsigned long&);
+		// Hash "previousHash" + "nonce".
+		static digest_type calcHash(const std::string&, unsigned long);
+		static digest_type calcHash(HashId, const std::string&, unsigned long);
+		// Identifier of block hash function.
+		static HashId hashId() { return Hasher::id; }
+		// True if hash meets difficulty level (hash, difficulty).
+		static bool meetsDifficulty(const digest_type&, unsigned int);
+
+		// Print formatted block data.
+		friend std::ostream& operator<< (std::ostream& os, const BasicBlock& b)
+		{
+			std::stringstream ss;
+
+			ss << std::setfill('0') << std::setw(sizeof(unsigned long) * 2) << std::hex << b.getHash();
+			return os << std::setfill(' ') << std::setw(2) << b.getID()
+				<< ":0x" << ss.str() << ":" << b.getNonce() << std::endl;
+		}
+
+		// Less than operator, only based upon comparison of block nonce!
+		bool operator< (const BasicBlock& rhs) const { return (this->nonce < rhs.nonce); }
+		// Equality operator, only based upon comparison of block nonce!
+		bool operator== (const BasicBlock& rhs) const { return (this->nonce == rhs.nonce); }
+
+	private:
+		// Private member data.
+		unsigned long id;         // Block identification number (id).
+		unsigned long nonce;      // Nonce, used in computing hash.
+		time_t timeId;            // Timestamp.
+		std::string hash;         // Hash of current block.
+		std::string previousHash; // Hash of previous block.
+
+		// Hash calculation.
+		inline digest_type calcHash() const;
+		// Hash calculation using specified nonce (thread safe).
+		inline digest_type calcHash(unsigned long) const;
+
+		// Sets time stamp to now (seconds past Unix epoch).
+		static time_t timeStamp();
+	};
+
+	typedef BasicBlock<> Block;
+}
+#endif
@@ -0,0 +1,292 @@
+/*************************************************************************
+* Title: Block Index
+* File: block_index.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Secondary indexes of blocks by id and by hash, kept next to the nonce
+* ordered Tree<Block>. Blocks are stored in slots (in insert order), and
+* flat hash maps give the slot of a block id, hash, or hash and id:
+*
+*   add(block)        // store block, index it, returns slot.
+*   byId(id)          // block with id, or nullptr.
+*   byHash(hash)      // first block added with hash, or nullptr.
+*   parent(block)     // block id - 1 whose hash is block's previous hash.
+*   walk(tip, visit)  // visit(block) from tip back to genesis, returns count.
+*   idStats(), hashStats(), linkStats() // entries, load, probe lengths,
+*                     // bytes per entry.
+*
+* FlatIndex is an open addressing (Robin Hood) map from a 64-bit key hash
+* to a slot. Entries are kept in separate arrays (probe distance, key
+* hash, slot), so a probe scans the 1 byte distances and only reads the
+* key hash and slot of candidates. Robin Hood insertion moves entries
+* closer to their home bucket than the new entry, which keeps probe
+* lengths short and lets a lookup stop at the first entry closer to home
+* than the probe.
+*
+* Notes:
+*  (1) Keys aren't stored in the maps, a key hash match is confirmed
+*      against the block in the slot. Ids are hashed with a 64-bit mixer,
+*      hash text with FNV-1a 64.
+*  (2) Every block is indexed, including the genesis block and blocks with
+*      duplicate nonces (which the tree skips). The id and hash maps keep
+*      the first block added with a key, adding a block with an indexed
+*      id or hash (ex. a fork reusing ids) stores it, but only indexes
+*      keys which are new.
+*  (3) Tables double when more than 7/8 full, or a probe distance would
+*      reach 255. Slots are indices, so they survive growth of the blocks.
+*  (4) Hashes aren't unique (a 32-bit digest repeats in a long chain, more
+*      so at high difficulty), so parent() uses a third map keyed on hash
+*      and id, and only accepts the block with the previous id. Repeated
+*      hashes get different key hashes there, rather than one long probe.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: parent() keyed on hash and id, for repeated hashes. JME
+*************************************************************************/
+#ifndef _BLOCK_INDEX_H_
+#define _BLOCK_INDEX_H_
+
+#include <algorithm>   // fill, max
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t, UINT32_MAX
+#include <iomanip>     // manipulators
+#include <ostream>     // stats
+#include <string>      // hashes
+#include <string_view> // hash text
+#include <utility>     // swap
+#include <vector>      // tables, slots
+
+#include "block.h"
+#include "hashers.h"
+
+namespace myIndex {
+
+	// Slot returned when a key isn't indexed.
+	constexpr uint32_t NO_SLOT = UINT32_MAX;
+	// Initial table size (buckets, power of 2).
+	constexpr std::size_t DEFAULT_INDEX_SIZE = 64;
+
+	struct IndexStats
+	{
+		std::size_t entries;   // Keys indexed.
+		std::size_t buckets;   // Table size.
+		double load;           // Entries per bucket.
+		double averageProbe;   // Buckets read by a successful lookup, on average.
+		unsigned int maxProbe; // Buckets read by the longest successful lookup.
+		double bytesPerEntry;  // Table memory per entry.
+	};
+
+	// 64-bit mixer (splitmix64 finalizer), spreads consecutive ids.
+	inline uint64_t mixKey(uint64_t k)
+	{
+		k ^= k >> 30;
+		k *= 0xbf58476d1ce4e5b9;
+		k ^= k >> 27;
+		k *= 0x94d049bb133111eb;
+		return k ^ (k >> 31);
+	}
+
+	class FlatIndex
+	{
+	private:
+		std::vector<uint8_t> distance; // Probe distance + 1 of entry (0 = empty).
+		std::vector<uint64_t> hashes;  // Key hash of entry.
+		std::vector<uint32_t> slots;   // Slot of entry.
+		std::size_t count;
+		std::size_t mask;
+
+		explicit FlatIndex(std::size_t buckets) : distance(buckets), hashes(buckets), slots(buckets), count(0), mask(buckets - 1) { }
+
+		// Place entry without checking for its key. Returns false if a probe
+		// distance overflows, h and slot are then the entry still to place.
+		bool place(uint64_t& h, uint32_t& slot)
+		{
+			std::size_t i = h & mask;
+			uint8_t d = 1;
+
+			for (;;)
+			{
+				if (!distance[i])
+				{
+					distance[i] = d;
+					hashes[i] = h;
+					slots[i] = slot;
+					count++;
+					return true;
+				}
+				// Take bucket from entry closer to its home, continue placing that entry.
+				if (distance[i] < d)
+				{
+					std::swap(distance[i], d);
+					std::swap(hashes[i], h);
+					std::swap(slots[i], slot);
+				}
+				if (d == UINT8_MAX)
+					return false;
+				d++;
+				i = (i + 1) & mask;
+			}
+		}
+
+		// Double table size, reinsert entries.
+		void grow()
+		{
+			FlatIndex bigger(distance.size() * 2);
+
+			for (std::size_t i = 0; i < distance.size(); i++)
+				if (distance[i])
+				{
+					uint64_t h = hashes[i];
+					uint32_t slot = slots[i];
+
+					while (!bigger.place(h, slot))
+						bigger.grow();
+				}
+			*this = std::move(bigger);
+		}
+
+	public:
+		FlatIndex() : FlatIndex(DEFAULT_INDEX_SIZE) { }
+
+		// Slot of key with hash h, or NO_SLOT. match(slot) confirms slot holds key.
+		template <class Match>
+		uint32_t find(uint64_t h, Match match) const
+		{
+			std::size_t i = h & mask;
+
+			for (unsigned int d = 1; distance[i] >= d; d++, i = (i + 1) & mask)
+				if (hashes[i] == h && match(slots[i]))
+					return slots[i];
+			return NO_SLOT;
+		}
+
+		// Index slot under key hash h, unless key is already indexed (false).
+		template <class Match>
+		bool insert(uint64_t h, uint32_t slot, Match match)
+		{
+			if (find(h, match) != NO_SLOT)
+				return false;
+			if ((count + 1) * 8 > distance.size() * 7)
+				grow();
+			while (!place(h, slot))
+				grow();
+			return true;
+		}
+
+		void clear()
+		{
+			std::fill(distance.begin(), distance.end(), 0);
+			count = 0;
+		}
+
+		std::size_t size() const { return count; }
+
+		IndexStats stats() const
+		{
+			std::size_t total = 0;
+			unsigned int longest = 0;
+
+			for (uint8_t d : distance)
+			{
+				total += d;
+				longest = std::max<unsigned int>(longest, d);
+			}
+
+			const std::size_t bytes = distance.size() * (sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t));
+			return IndexStats{ count, distance.size(), static_cast<double>(count) / distance.size(),
+				count ? static_cast<double>(total) / count : 0, longest, count ? static_cast<double>(bytes) / count : 0 };
+		}
+	};
+
+	template <class BlockType = myBlock::Block>
+	class BlockIndex
+	{
+	private:
+		std::vector<BlockType> blocks; // Slots.
+		FlatIndex ids;
+		FlatIndex hashes;
+		FlatIndex links; // Hash and id.
+
+		static uint64_t idHash(unsigned long id) { return mixKey(id); }
+		static uint64_t textHash(std::string_view hash) { return Fnv1a64::hash(hash); }
+		static uint64_t linkHash(std::string_view hash, unsigned long id) { return textHash(hash) ^ idHash(id); }
+
+		const BlockType* at(uint32_t slot) const { return slot == NO_SLOT ? nullptr : &blocks[slot]; }
+
+	public:
+		// Store block, index its id, hash, and hash and id. Returns slot.
+		uint32_t add(const BlockType& b)
+		{
+			const uint32_t slot = static_cast<uint32_t>(blocks.size());
+			const unsigned long id = b.getID();
+			const std::string hash = b.getHash();
+
+			blocks.push_back(b);
+			ids.insert(idHash(id), slot, [&](uint32_t s) { return blocks[s].getID() == id; });
+			hashes.insert(textHash(hash), slot, [&](uint32_t s) { return blocks[s].getHash() == hash; });
+			links.insert(linkHash(hash, id), slot, [&](uint32_t s) { return blocks[s].getID() == id && blocks[s].getHash() == hash; });
+			return slot;
+		}
+
+		const BlockType* byId(unsigned long id) const
+		{
+			return at(ids.find(idHash(id), [&](uint32_t s) { return blocks[s].getID() == id; }));
+		}
+
+		const BlockType* byHash(const std::string& hash) const
+		{
+			return at(hashes.find(textHash(hash), [&](uint32_t s) { return blocks[s].getHash() == hash; }));
+		}
+
+		// Previous block in chain, or nullptr (genesis block).
+		const BlockType* parent(const BlockType& b) const
+		{
+			if (!b.getID())
+				return nullptr;
+
+			const unsigned long id = b.getID() - 1;
+			const std::string hash = b.getPreviousHash();
+			return at(links.find(linkHash(hash, id), [&](uint32_t s) { return blocks[s].getID() == id && blocks[s].getHash() == hash; }));
+		}
+
+		// Visit blocks from tip back along previous hashes, returns blocks visited.
+		// Each step decreases the id, so a walk always ends.
+		template <class Visit>
+		std::size_t walk(const BlockType& tip, Visit visit) const
+		{
+			std::size_t n = 0;
+
+			for (const BlockType* b = &tip; b; b = parent(*b), n++)
+				visit(*b);
+			return n;
+		}
+
+		// Block in slot (insert order).
+		const BlockType& operator[] (std::size_t slot) const { return blocks[slot]; }
+
+		void clear()
+		{
+			blocks.clear();
+			ids.clear();
+			hashes.clear();
+			links.clear();
+		}
+
+		std::size_t size() const { return blocks.size(); }
+		bool empty() const { return blocks.empty(); }
+
+		IndexStats idStats() const { return ids.stats(); }
+		IndexStats hashStats() const { return hashes.stats(); }
+		IndexStats linkStats() const { return links.stats(); }
+	};
+
+	inline std::ostream& operator<< (std::ostream& os, const IndexStats& s)
+	{
+		return os << s.entries << " entries, " << s.buckets << " buckets, load " << std::fixed << std::setprecision(2) << s.load
+			<< ", probe avg " << s.averageProbe << " max " << s.maxProbe << ", " << std::setprecision(1) << s.bytesPerEntry << " bytes/entry";
+	}
+}
+
+#endif
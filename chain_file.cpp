@@ -0,0 +1,418 @@
+/*************************************************************************
+* Title: Chain File
+* File: chain_file.cpp
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Append-only chain file writer, and memory mapped reader.
+*
+* Notes:
+*  (1) Uses mmap on POSIX systems and file mapping objects on Windows.
+*  (2) Header and footer are checked on open, records are not. Use
+*      CompactBlock::isHashValid() to check a block.
+*  (3) The writer uses pread/pwrite/fsync on POSIX systems and overlapped
+*      ReadFile/WriteFile/FlushFileBuffers on Windows.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Writer syncs flushes and keeps a header checkpoint, readers
+*               fall back to it when a flush was interrupted. JME
+*************************************************************************/
+#include <cerrno>    // errno
+#include <cstddef>   // offsetof
+#include <cstring>   // memcpy, memcmp
+#include <utility>   // swap
+#include "chain_file.h"
+#include "hash_funcs.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close, pread, pwrite, fsync, ftruncate
+#endif
+
+using namespace myChain;
+
+// Header and footer magic numbers.
+static const char HEADER_MAGIC[8] = { 'B', 'L', 'K', 'C', 'H', 'A', 'I', 'N' };
+static const char FOOTER_MAGIC[8] = { 'C', 'H', 'A', 'I', 'N', 'E', 'N', 'D' };
+
+// Size of a chain file with count records.
+static uint64_t fileSize(uint64_t count) { return sizeof(ChainHeader) + count * sizeof(CompactBlock) + sizeof(ChainFooter); }
+
+// Checksum of footer or checkpoint fields preceding checksum.
+template <class State>
+static uint32_t stateChecksum(const State& s)
+{
+	return crc_32(reinterpret_cast<const char*>(&s), offsetof(State, checksum));
+}
+
+// Throw if header doesn't describe a chain readable by this build.
+static void checkHeader(const ChainHeader& h)
+{
+	if (std::memcmp(h.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)))
+		throw std::runtime_error("not a chain file");
+	if (h.version != CHAIN_VERSION)
+		throw std::runtime_error("unsupported chain file version");
+	if (h.recordSize != sizeof(CompactBlock))
+		throw std::runtime_error("chain file record size mismatch");
+	if (h.hashId != static_cast<uint32_t>(Block::hashId()))
+		throw std::runtime_error("chain file hash function mismatch");
+}
+
+// Set footer f (read from end of file) to the state of the last complete
+// flush. That is f itself if valid and matching the file size, otherwise
+// (flush interrupted) the header checkpoint. Returns false if f was
+// replaced, throws if neither is valid.
+static bool lastFlush(const ChainHeader& h, ChainFooter& f, uint64_t size)
+{
+	if (!std::memcmp(f.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) && f.checksum == stateChecksum(f)
+		&& f.count <= (size - fileSize(0)) / sizeof(CompactBlock) && fileSize(f.count) == size)
+		return true;
+
+	// Records of the checkpoint are complete, anything after them is torn.
+	const ChainCheckpoint& c = h.checkpoint;
+	if (c.checksum != stateChecksum(c) || c.count > (size - sizeof(ChainHeader)) / sizeof(CompactBlock))
+		throw std::runtime_error("chain file footer damaged");
+
+	f = ChainFooter{ c.count, c.firstId, c.lastId, c.lastHash, c.checksum, {}, {} };
+	std::memcpy(f.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+	return false;
+}
+
+/*************************************************************************
+ * Platform file access for the writer. Offsets are absolute, failures
+ * throw.
+*************************************************************************/
+#if defined(_WIN32)
+static const std::intptr_t NO_FILE = reinterpret_cast<std::intptr_t>(INVALID_HANDLE_VALUE);
+
+static HANDLE fileHandle(std::intptr_t f) { return reinterpret_cast<HANDLE>(f); }
+
+// Open existing file for update, or create it (created set).
+static std::intptr_t openFile(const std::string& path, bool& created)
+{
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (f == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("unable to open chain file " + path);
+	created = GetLastError() != ERROR_ALREADY_EXISTS;
+	return reinterpret_cast<std::intptr_t>(f);
+}
+
+static void closeFile(std::intptr_t f) { CloseHandle(fileHandle(f)); }
+
+static uint64_t fileLength(std::intptr_t f)
+{
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fileHandle(f), &size))
+		throw std::runtime_error("unable to read chain file");
+	return static_cast<uint64_t>(size.QuadPart);
+}
+
+static void readAt(std::intptr_t f, uint64_t offset, void* data, std::size_t len)
+{
+	OVERLAPPED at{};
+	DWORD done = 0;
+
+	at.Offset = static_cast<DWORD>(offset);
+	at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+	if (!ReadFile(fileHandle(f), data, static_cast<DWORD>(len), &done, &at) || done != len)
+		throw std::runtime_error("unable to read chain file");
+}
+
+static void writeAt(std::intptr_t f, uint64_t offset, const void* data, std::size_t len)
+{
+	OVERLAPPED at{};
+	DWORD done = 0;
+
+	at.Offset = static_cast<DWORD>(offset);
+	at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+	if (len && (!WriteFile(fileHandle(f), data, static_cast<DWORD>(len), &done, &at) || done != len))
+		throw std::runtime_error("unable to write chain file");
+}
+
+static void syncFile(std::intptr_t f)
+{
+	if (!FlushFileBuffers(fileHandle(f)))
+		throw std::runtime_error("unable to write chain file");
+}
+
+static void truncateFile(std::intptr_t f, uint64_t size)
+{
+	LARGE_INTEGER at;
+
+	at.QuadPart = static_cast<LONGLONG>(size);
+	if (!SetFilePointerEx(fileHandle(f), at, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle(f)))
+		throw std::runtime_error("unable to write chain file");
+}
+#else
+static const std::intptr_t NO_FILE = -1;
+
+// Open existing file for update, or create it (created set).
+static std::intptr_t openFile(const std::string& path, bool& created)
+{
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+	created = fd >= 0;
+	if (!created && errno == EEXIST)
+		fd = ::open(path.c_str(), O_RDWR);
+	if (fd < 0)
+		throw std::runtime_error("unable to open chain file " + path);
+	return fd;
+}
+
+static void closeFile(std::intptr_t f) { ::close(static_cast<int>(f)); }
+
+static uint64_t fileLength(std::intptr_t f)
+{
+	struct stat st;
+	if (::fstat(static_cast<int>(f), &st))
+		throw std::runtime_error("unable to read chain file");
+	return static_cast<uint64_t>(st.st_size);
+}
+
+static void readAt(std::intptr_t f, uint64_t offset, void* data, std::size_t len)
+{
+	if (::pread(static_cast<int>(f), data, len, static_cast<off_t>(offset)) != static_cast<ssize_t>(len))
+		throw std::runtime_error("unable to read chain file");
+}
+
+static void writeAt(std::intptr_t f, uint64_t offset, const void* data, std::size_t len)
+{
+	const char* p = static_cast<const char*>(data);
+
+	// pwrite may write less than asked.
+	while (len)
+	{
+		ssize_t n = ::pwrite(static_cast<int>(f), p, len, static_cast<off_t>(offset));
+		if (n <= 0)
+			throw std::runtime_error("unable to write chain file");
+		p += n;
+		offset += n;
+		len -= n;
+	}
+}
+
+static void syncFile(std::intptr_t f)
+{
+	if (::fsync(static_cast<int>(f)))
+		throw std::runtime_error("unable to write chain file");
+}
+
+static void truncateFile(std::intptr_t f, uint64_t size)
+{
+	if (::ftruncate(static_cast<int>(f), static_cast<off_t>(size)))
+		throw std::runtime_error("unable to write chain file");
+}
+#endif
+
+/*************************************************************************
+ * Writer.
+*************************************************************************/
+ChainWriter::ChainWriter(const std::string& path, unsigned int difficulty)
+	: file(NO_FILE), header(), footer(), dataEnd(sizeof(ChainHeader)), synced(false)
+{
+	bool created;
+
+	file = openFile(path, created);
+	try
+	{
+		if (created)
+		{
+			// Empty chain.
+			std::memcpy(header.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+			header.version = CHAIN_VERSION;
+			header.hashId = static_cast<uint32_t>(Block::hashId());
+			header.recordSize = sizeof(CompactBlock);
+			header.difficulty = difficulty;
+			std::memcpy(footer.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+
+			writeAt(file, 0, &header, sizeof(header));
+			flush();
+			return;
+		}
+
+		// Append to existing chain.
+		uint64_t size = fileLength(file);
+		if (size < fileSize(0))
+			throw std::runtime_error("not a chain file");
+
+		readAt(file, 0, &header, sizeof(header));
+		readAt(file, size - sizeof(ChainFooter), &footer, sizeof(footer));
+		checkHeader(header);
+		if (header.difficulty != difficulty)
+			throw std::runtime_error("chain file difficulty mismatch");
+
+		synced = lastFlush(header, footer, size);
+		dataEnd = sizeof(ChainHeader) + footer.count * sizeof(CompactBlock);
+		if (!synced)
+		{
+			// Drop torn tail of interrupted flush, rewrite footer.
+			truncateFile(file, dataEnd);
+			flush();
+		}
+	}
+	catch (...)
+	{
+		closeFile(file);
+		throw;
+	}
+}
+
+ChainWriter::~ChainWriter()
+{
+	try { flush(); }
+	catch (...) { }
+	closeFile(file);
+}
+
+// Append block, which must follow the last block of the chain.
+void ChainWriter::append(const CompactBlock& b)
+{
+	if (footer.count)
+	{
+		if (b.getID() != footer.lastId + 1 || b.getPreviousHash() != footer.lastHash)
+			throw std::invalid_argument("block does not extend chain");
+	}
+	else
+		footer.firstId = b.getID();
+
+	footer.lastId = b.getID();
+	footer.lastHash = b.getHash();
+	footer.count++;
+	pending.push_back(b);
+	synced = false;
+}
+
+// Write pending records over old footer, followed by new footer. Only once
+// both reach storage is the checkpoint moved past the old records, so a
+// crash at any point leaves the footer or the checkpoint describing
+// complete records.
+void ChainWriter::flush()
+{
+	if (synced)
+		return;
+
+	const std::size_t bytes = pending.size() * sizeof(CompactBlock);
+
+	footer.checksum = stateChecksum(footer);
+	writeAt(file, dataEnd, pending.data(), bytes);
+	writeAt(file, dataEnd + bytes, &footer, sizeof(footer));
+	syncFile(file);
+	dataEnd += bytes;
+	pending.clear();
+
+	header.checkpoint = ChainCheckpoint{ footer.count, footer.firstId, footer.lastId, footer.lastHash, 0 };
+	header.checkpoint.checksum = stateChecksum(header.checkpoint);
+	writeAt(file, offsetof(ChainHeader, checkpoint), &header.checkpoint, sizeof(header.checkpoint));
+	syncFile(file);
+	synced = true;
+}
+
+/*************************************************************************
+ * Reader.
+*************************************************************************/
+ChainReader::ChainReader(const std::string& path) : base(nullptr), length(0), handle(nullptr), records(nullptr), header(), footer()
+{
+#if defined(_WIN32)
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (f == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("unable to open chain file " + path);
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size) || static_cast<uint64_t>(size.QuadPart) < fileSize(0))
+	{
+		CloseHandle(f);
+		throw std::runtime_error("not a chain file");
+	}
+	length = static_cast<std::size_t>(size.QuadPart);
+
+	handle = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(f);
+	if (handle)
+		base = static_cast<const uint8_t*>(MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+	if (!base)
+	{
+		unmap();
+		throw std::runtime_error("unable to map chain file " + path);
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("unable to open chain file " + path);
+
+	struct stat st;
+	if (::fstat(fd, &st) || static_cast<uint64_t>(st.st_size) < fileSize(0))
+	{
+		::close(fd);
+		throw std::runtime_error("not a chain file");
+	}
+	length = static_cast<std::size_t>(st.st_size);
+
+	// Mapping stays valid after descriptor is closed.
+	void* p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED)
+		throw std::runtime_error("unable to map chain file " + path);
+	base = static_cast<const uint8_t*>(p);
+#endif
+
+	try
+	{
+		std::memcpy(&header, base, sizeof(header));
+		std::memcpy(&footer, base + length - sizeof(ChainFooter), sizeof(footer));
+		checkHeader(header);
+		lastFlush(header, footer, length);
+	}
+	catch (...)
+	{
+		unmap();
+		throw;
+	}
+
+	records = reinterpret_cast<const CompactBlock*>(base + sizeof(ChainHeader));
+}
+
+ChainReader::ChainReader(ChainReader&& rhs) : base(nullptr), length(0), handle(nullptr), records(nullptr), header(), footer()
+{
+	*this = std::move(rhs);
+}
+
+ChainReader& ChainReader::operator= (ChainReader&& rhs)
+{
+	if (this != &rhs)
+	{
+		unmap();
+		std::swap(base, rhs.base);
+		std::swap(length, rhs.length);
+		std::swap(handle, rhs.handle);
+		std::swap(records, rhs.records);
+		header = rhs.header;
+		footer = rhs.footer;
+		rhs.footer.count = 0;
+	}
+	return *this;
+}
+
+// Release mapping.
+void ChainReader::unmap()
+{
+#if defined(_WIN32)
+	if (base)
+		UnmapViewOfFile(base);
+	if (handle)
+		CloseHandle(handle);
+#else
+	if (base)
+		::munmap(const_cast<uint8_t*>(base), length);
+#endif
+	base = nullptr;
+	handle = nullptr;
+	records = nullptr;
+	length = 0;
+}
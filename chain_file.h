@@ -0,0 +1,185 @@
+/*************************************************************************
+* Title: Chain File
+* File: chain_file.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Binary, append-only blockchain file. Blocks are stored as fixed size
+* CompactBlock records (see compact_block.h) between a header and a footer:
+*
+*   header   magic, version, hash function id, record size, difficulty.
+*   records  CompactBlock[count], in chain order.
+*   footer   count, first/last block id, last hash, checksum, magic.
+*
+* ChainWriter appends blocks. New records overwrite the old footer and a new
+* footer is written after them. Once they reach storage, the header's
+* checkpoint (a copy of the footer fields) is updated. A flush interrupted
+* by a crash leaves a damaged footer, but the checkpoint still describes
+* the chain as of the previous flush, whose records are never overwritten.
+* Readers fall back to the checkpoint, and the writer truncates the torn
+* tail on reopen, so a chain never has to be mined again.
+*
+* ChainReader maps the whole file into memory (mmap) and returns blocks in
+* place, without reading or converting them. Opening only checks the header
+* and footer, so open time doesn't depend on chain length.
+*
+*   size()           // number of blocks.
+*   operator[](i)    // block i (at(i) checks range).
+*   begin(), end()   // iterate blocks.
+*   findById(id)     // block with id, or nullptr.
+*
+* Notes:
+*  (1) Records are stored in native (little endian on x86/x64) byte order.
+*  (2) Header and footer are 64 and 48 bytes, keeping records 8 byte aligned
+*      inside the mapping.
+*  (3) Block ids are consecutive in a chain, so findById() is a range check
+*      and an array index.
+*  (4) Writes use the platform file API, so flush() can sync records and
+*      footer before the checkpoint (fsync, FlushFileBuffers).
+*  (5) The checkpoint lives in bytes reserved (zero) in earlier files, which
+*      simply have no valid checkpoint until their next flush.
+*  (6) Records are CompactBlocks, so only chains of Block (BlockHasher)
+*      can be saved. The header's hash function id is always Block's.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Header checkpoint of last flush, synced writes. A crash
+*               during flush() no longer loses the chain. JME
+*   10/17/2026: Noted only Block chains can be saved. JME
+*************************************************************************/
+#ifndef _CHAIN_FILE_H_
+#define _CHAIN_FILE_H_
+
+#include <cstddef>   // size_t
+#include <cstdint>   // fixed width ints, intptr_t
+#include <stdexcept> // runtime error
+#include <string>    // file path
+#include <vector>    // pending records
+
+#include "block.h"
+#include "compact_block.h"
+
+namespace myChain {
+
+	using myBlock::Block;
+	using myBlock::CompactBlock;
+
+	// Current file format version.
+	constexpr uint32_t CHAIN_VERSION = 1;
+
+	// Chain state as of last complete flush (same fields as footer).
+	struct ChainCheckpoint
+	{
+		uint64_t count;       // Number of records.
+		uint64_t firstId;     // Id of first block.
+		uint64_t lastId;      // Id of last block.
+		uint32_t lastHash;    // Hash of last block.
+		uint32_t checksum;    // CRC-32 of preceding fields.
+	};
+
+	// File header.
+	struct ChainHeader
+	{
+		char magic[8];              // "BLKCHAIN"
+		uint32_t version;           // Format version.
+		uint32_t hashId;            // Block hash function (HashId).
+		uint32_t recordSize;        // sizeof(CompactBlock).
+		uint32_t difficulty;        // Mining difficulty.
+		ChainCheckpoint checkpoint; // Written after each flush reaches storage.
+		uint8_t reserved[8];        // Zero.
+	};
+
+	// File footer.
+	struct ChainFooter
+	{
+		uint64_t count;       // Number of records.
+		uint64_t firstId;     // Id of first block.
+		uint64_t lastId;      // Id of last block.
+		uint32_t lastHash;    // Hash of last block (previous hash of next).
+		uint32_t checksum;    // CRC-32 of preceding footer fields.
+		char magic[8];        // "CHAINEND"
+		uint8_t reserved[8];  // Zero.
+	};
+
+	static_assert(sizeof(ChainCheckpoint) == 32, "chain checkpoint must be 32 bytes");
+	static_assert(sizeof(ChainHeader) == 64, "chain header must be 64 bytes");
+	static_assert(sizeof(ChainFooter) == 48, "chain footer must be 48 bytes");
+
+	class ChainWriter
+	{
+	private:
+		std::intptr_t file;                // File descriptor (POSIX) or handle (Windows).
+		ChainHeader header;                // Header, as written.
+		ChainFooter footer;                // Footer after pending records.
+		std::vector<CompactBlock> pending; // Records not yet written.
+		uint64_t dataEnd;                  // Offset of footer in file.
+		bool synced;                       // File holds current footer and checkpoint.
+
+	public:
+		// Open existing chain for append, or create chain (path, difficulty).
+		ChainWriter(const std::string&, unsigned int);
+		// Flushes pending records.
+		~ChainWriter();
+
+		ChainWriter(const ChainWriter&) = delete;
+		ChainWriter& operator= (const ChainWriter&) = delete;
+
+		// Append block. Ids must be consecutive.
+		void append(const CompactBlock&);
+		void append(const Block& b) { append(CompactBlock(b)); }
+
+		// Write pending records and footer, sync, then update checkpoint.
+		void flush();
+
+		// Number of blocks, including pending.
+		std::size_t size() const { return static_cast<std::size_t>(footer.count); }
+	};
+
+	class ChainReader
+	{
+	private:
+		const uint8_t* base;         // Start of mapping.
+		std::size_t length;          // Mapping length.
+		void* handle;                // Platform mapping handle (Windows).
+		const CompactBlock* records; // First record.
+		ChainHeader header;
+		ChainFooter footer;
+
+		void unmap();
+
+	public:
+		// Map chain file (path).
+		explicit ChainReader(const std::string&);
+		~ChainReader() { unmap(); }
+
+		ChainReader(const ChainReader&) = delete;
+		ChainReader& operator= (const ChainReader&) = delete;
+		ChainReader(ChainReader&&);
+		ChainReader& operator= (ChainReader&&);
+
+		std::size_t size() const { return static_cast<std::size_t>(footer.count); }
+		unsigned int difficulty() const { return header.difficulty; }
+
+		const CompactBlock& operator[] (std::size_t i) const { return records[i]; }
+		const CompactBlock& at(std::size_t i) const
+		{
+			if (i >= size())
+				throw std::out_of_range("chain block index out of range");
+			return records[i];
+		}
+
+		const CompactBlock* begin() const { return records; }
+		const CompactBlock* end() const { return records + size(); }
+
+		// Block with id, or nullptr.
+		const CompactBlock* findById(uint64_t id) const
+		{
+			if (!size() || id < footer.firstId || id > footer.lastId)
+				return nullptr;
+			return &records[id - footer.firstId];
+		}
+	};
+}
+
+#endif
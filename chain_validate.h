@@ -0,0 +1,194 @@
+/*************************************************************************
+* Title: Chain Validation
+* File: chain_validate.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Validates a whole chain of blocks (Block or CompactBlock array, or a
+* chain file). For each block i, checks:
+*
+*   id           id is first block id + i.
+*   hash         stored hash matches "previousHash" + "nonce" hash.
+*   difficulty   stored hash meets difficulty level.
+*   link         previous hash matches hash of block i - 1 (i > 0).
+*
+* Works for blocks of any hasher (BasicBlock<Hasher>), digests are compared
+* as digests, and difficulty is tested with the block type's own
+* meetsDifficulty(). Every check only reads stored hashes, so blocks are
+* checked in any
+* order. The chain is split into chunks which threads claim from a shared
+* counter (same as the mining search). Returns the first bad block.
+*
+*   validateChain(blocks, count, difficulty, threads, cancel)
+*   validateChain(chainReader, difficulty, threads, cancel)
+*
+* Notes:
+*  (1) A thread count of 0 uses all hardware threads.
+*  (2) Once a bad block is found, chunks after it are skipped, and chunks
+*      before it are still checked, so the result is always the lowest
+*      bad block, for any thread count.
+*  (3) Setting the optional cancel flag stops all threads after their
+*      current chunk. A cancelled validation reports ChainError::Cancelled
+*      unless a bad block was already found.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Generic over block digest type, no hash text parsing. JME
+*************************************************************************/
+#ifndef _CHAIN_VALIDATE_H_
+#define _CHAIN_VALIDATE_H_
+
+#include <algorithm> // max
+#include <atomic>    // chunk counter, first bad block
+#include <cstddef>   // size_t
+#include <cstdint>   // uint64_t
+#include <thread>    // worker threads
+#include <vector>    // worker threads
+
+#include "block.h"
+#include "chain_file.h"
+#include "compact_block.h"
+
+namespace myChain {
+
+	// Number of blocks a validation thread claims at a time.
+	constexpr std::size_t VALIDATE_CHUNK_SIZE = 4096;
+
+	// Reason a block failed validation.
+	enum class ChainError { None, Id, Hash, Difficulty, Link, Cancelled };
+
+	struct ChainStatus
+	{
+		ChainError error;  // First failure (None if chain valid).
+		std::size_t index; // Index of bad block (block count if none).
+
+		bool valid() const { return error == ChainError::None; }
+	};
+
+	// Printable name of error.
+	inline const char* chainErrorName(ChainError e)
+	{
+		switch (e)
+		{
+		case ChainError::None:       return "none";
+		case ChainError::Id:         return "id";
+		case ChainError::Hash:       return "hash";
+		case ChainError::Difficulty: return "difficulty";
+		case ChainError::Link:       return "link";
+		default:                     return "cancelled";
+		}
+	}
+
+	// Calculated hash of block, false if it doesn't match stored hash.
+	template <class Hasher>
+	bool blockDigest(const myBlock::BasicBlock<Hasher>& b, typename Hasher::digest_type& h)
+	{
+		h = myBlock::BasicBlock<Hasher>::calcHash(b.getPreviousHash(), b.getNonce());
+		return digestString(h) == b.getHash();
+	}
+
+	template <class Digest>
+	bool blockDigest(const myBlock::BasicCompactBlock<Digest>& b, Digest& h)
+	{
+		h = b.getHash();
+		return b.isHashValid();
+	}
+
+	// Check block i of chain (blocks, index, first id, difficulty).
+	template <class BlockType>
+	ChainError checkBlock(const BlockType* blocks, std::size_t i, uint64_t firstId, unsigned int difficulty)
+	{
+		const BlockType& b = blocks[i];
+		typename BlockType::digest_type h;
+
+		if (b.getID() != firstId + i)
+			return ChainError::Id;
+		if (!blockDigest(b, h))
+			return ChainError::Hash;
+		if (!BlockType::meetsDifficulty(h, difficulty))
+			return ChainError::Difficulty;
+		if (i && !(b.getPreviousHash() == blocks[i - 1].getHash()))
+			return ChainError::Link;
+		return ChainError::None;
+	}
+
+	// Validate chain of blocks (blocks, count, difficulty, threads, cancel flag).
+	template <class BlockType>
+	ChainStatus validateChain(const BlockType* blocks, std::size_t count, unsigned int difficulty,
+		unsigned int threads = 0, const std::atomic<bool>* cancel = nullptr)
+	{
+		// Throws for invalid difficulty here, rather than inside a thread.
+		BlockType::meetsDifficulty(typename BlockType::digest_type(), difficulty);
+
+		if (!count)
+			return ChainStatus{ ChainError::None, 0 };
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		const std::size_t chunks = (count + VALIDATE_CHUNK_SIZE - 1) / VALIDATE_CHUNK_SIZE;
+		const uint64_t firstId = blocks[0].getID();
+		std::atomic<std::size_t> next(0);      // Next unclaimed chunk.
+		std::atomic<std::size_t> bad(count);   // Lowest bad block.
+		std::vector<ChainError> errors(chunks, ChainError::None); // Failure of each chunk.
+		std::atomic<bool> cancelled(false);
+
+		auto worker = [&]()
+		{
+			for (;;)
+			{
+				std::size_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+				std::size_t first = chunk * VALIDATE_CHUNK_SIZE;
+
+				if (chunk >= chunks || first > bad.load(std::memory_order_relaxed))
+					return;
+				if (cancel && cancel->load(std::memory_order_relaxed))
+				{
+					cancelled.store(true, std::memory_order_relaxed);
+					return;
+				}
+
+				std::size_t last = std::min(first + VALIDATE_CHUNK_SIZE, count);
+				for (std::size_t i = first; i < last; i++)
+				{
+					ChainError e = checkBlock(blocks, i, firstId, difficulty);
+
+					if (e != ChainError::None)
+					{
+						// Keep the lowest bad block.
+						errors[chunk] = e;
+						std::size_t current = bad.load(std::memory_order_relaxed);
+						while (i < current && !bad.compare_exchange_weak(current, i, std::memory_order_relaxed))
+							;
+						break;
+					}
+				}
+			}
+		};
+
+		if (threads == 1)
+			worker();
+		else
+		{
+			std::vector<std::thread> pool;
+			for (unsigned int t = 0; t < threads; t++)
+				pool.emplace_back(worker);
+			for (auto& t : pool)
+				t.join();
+		}
+
+		std::size_t i = bad.load();
+		if (i < count)
+			return ChainStatus{ errors[i / VALIDATE_CHUNK_SIZE], i };
+		return ChainStatus{ cancelled.load() ? ChainError::Cancelled : ChainError::None, count };
+	}
+
+	// Validate mapped chain file (chain, difficulty, threads, cancel flag).
+	inline ChainStatus validateChain(const ChainReader& chain, unsigned int difficulty,
+		unsigned int threads = 0, const std::atomic<bool>* cancel = nullptr)
+	{
+		return validateChain(chain.begin(), chain.size(), difficulty, threads, cancel);
+	}
+}
+
+#endif
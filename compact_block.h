@@ -0,0 +1,136 @@
+/*************************************************************************
+* Title: Compact Block class
+* File: compact_block.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Fixed width, trivially copyable alternative to myBlock::Block. Hashes
+* are stored as binary digests instead of decimal text, accessors return
+* by reference, and text is only produced by the << operator. Blocks can
+* be copied with memcpy and stored in bulk (arrays, files).
+*
+* Produces the same hashes and nonces as Block: a 32-bit digest's decimal
+* text is exactly Block's hash string, so the hash of "previousHash" +
+* "nonce" is unchanged. Blocks convert both ways.
+*
+* Notes:
+*  (1) Layout is 32 bytes for a 32-bit digest (Block is 88 bytes plus two
+*      strings on x64).
+*  (2) Digest is a template parameter so wider (ex. 256-bit) digests only
+*      need a matching hash function. Hashes come from Block::calcHash, so
+*      Digest must currently be Block's digest type (32-bit). Blocks of
+*      other hashers (BasicBlock<Fnv1a64>, BasicBlock<Sha256>) have no
+*      compact form, and so can't be saved to a chain file.
+*  (3) A tree of compact blocks clears in O(1), see pool.h.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: MineBlock() no longer prints, records stats. JME
+*   10/17/2026: Digest must match Block's digest type. JME
+*   10/17/2026: Added digest_type, meetsDifficulty() for validation. JME
+*   10/17/2026: Noted blocks of other hashers have no compact form. JME
+*************************************************************************/
+#ifndef _COMPACT_BLOCK_H_
+#define _COMPACT_BLOCK_H_
+
+#include <cstdint>     // fixed width ints
+#include <ctime>       // time()
+#include <iomanip>     // manipulators
+#include <iostream>    // ostream
+#include <string>      // string conversion
+#include <type_traits> // trivially copyable
+#include "block.h"     // myBlock::Block, mining
+#include "stats.h"     // mining stats
+
+namespace myBlock {
+
+	template <class Digest = uint32_t>
+	class BasicCompactBlock
+	{
+		static_assert(std::is_same<Digest, Block::digest_type>::value, "digest must be Block's digest type (see calcHash)");
+
+	public:
+		typedef Digest digest_type;
+
+		// Default ctor.
+		BasicCompactBlock() = default;
+		// All members except hash ctor (id, previous hash, nonce).
+		BasicCompactBlock(uint64_t i, Digest ph, uint64_t n)
+			: id(i), nonce(n), timeId(std::time(0)), hash(calcHash(ph, n)), previousHash(ph) { }
+		// Convert from block.
+		explicit BasicCompactBlock(const Block& b)
+			: id(b.getID()), nonce(b.getNonce()), timeId(b.getTimeID()),
+			hash(static_cast<Digest>(std::stoull(b.getHash()))),
+			previousHash(static_cast<Digest>(std::stoull(b.getPreviousHash()))) { }
+
+		// Convert to block.
+		Block toBlock() const
+		{
+			Block b(static_cast<unsigned long>(id), std::to_string(previousHash), static_cast<unsigned long>(nonce));
+
+			b.setHash(std::to_string(hash));
+			b.setTimeID(static_cast<time_t>(timeId));
+			return b;
+		}
+
+		// Accessor functions.
+		uint64_t getID() const { return id; }
+		void setID(uint64_t i) { id = i; }
+		uint64_t getNonce() const { return nonce; }
+		void setNonce(uint64_t n) { nonce = n; }
+		int64_t getTimeID() const { return timeId; }
+		void setTimeID(int64_t ts) { timeId = ts; }
+		const Digest& getHash() const { return hash; }
+		void setHash(Digest h) { hash = h; }
+		const Digest& getPreviousHash() const { return previousHash; }
+		void setPreviousHash(Digest ph) { previousHash = ph; }
+
+		// Mine block (difficulty, thread count), see Block::MineBlock.
+		void MineBlock(unsigned int difficulty, unsigned int threads = 1)
+		{
+			STATS_BLOCK_START(static_cast<unsigned long>(nonce));
+			nonce = Block::findNonce(std::to_string(previousHash), static_cast<unsigned long>(nonce), difficulty, threads);
+			STATS_BLOCK_END(static_cast<unsigned long>(id), static_cast<unsigned long>(nonce), threads);
+			hash = calcHash(previousHash, nonce);
+		}
+
+		// Validate stored hash against calculated hash to prevent forgery.
+		bool isHashValid() const { return calcHash(previousHash, nonce) == hash; }
+		// True if hash meets difficulty level (hash, difficulty).
+		static bool meetsDifficulty(const Digest& h, unsigned int difficulty) { return DifficultyTarget<Digest>(difficulty).met(h); }
+
+		// Print formatted block data (same format as Block).
+		friend std::ostream& operator<< (std::ostream& os, const BasicCompactBlock& b)
+		{
+			return os << std::setfill(' ') << std::setw(2) << b.id << ":0x" << std::setfill('0')
+				<< std::setw(sizeof(unsigned long) * 2) << std::dec << b.hash << std::setfill(' ')
+				<< ":" << b.nonce << std::endl;
+		}
+
+		// Less than operator, only based upon comparison of block nonce!
+		bool operator< (const BasicCompactBlock& rhs) const { return (nonce < rhs.nonce); }
+		// Equality operator, only based upon comparison of block nonce!
+		bool operator== (const BasicCompactBlock& rhs) const { return (nonce == rhs.nonce); }
+
+	private:
+		uint64_t id;         // Block identification number (id).
+		uint64_t nonce;      // Nonce, used in computing hash.
+		int64_t timeId;      // Timestamp.
+		Digest hash;         // Hash of current block.
+		Digest previousHash; // Hash of previous block.
+
+		// Hash "previousHash" + "nonce". Digest text fits small string buffer.
+		static Digest calcHash(Digest ph, uint64_t n)
+		{
+			return static_cast<Digest>(Block::calcHash(std::to_string(ph), static_cast<unsigned long>(n)));
+		}
+	};
+
+	typedef BasicCompactBlock<> CompactBlock;
+
+	static_assert(std::is_trivially_copyable<CompactBlock>::value, "CompactBlock must be trivially copyable");
+	static_assert(sizeof(CompactBlock) == 32, "CompactBlock should be 32 bytes");
+}
+
+#endif
@@ -0,0 +1,445 @@
+/*************************************************************************
+* Title: Concurrent Tree
+* File: concurrent_tree.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Binary search tree shared by many threads. Any number of readers look up
+* and traverse the tree while writers insert, and readers never wait on
+* writers (or on each other):
+*
+*   add(T)           // insert new node (writers, serialized).
+*   insertUnique(T)  // insert only if T doesn't already exist.
+*   find(T)          // true if T is in the current version.
+*   snapshot()       // read-only view of the current version.
+*   size(), getHeight(), empty() // of the current version.
+*   retiredNodes()   // replaced nodes waiting to be freed.
+*   reclaimedNodes() // replaced nodes freed so far.
+*
+* Snapshot (read-only, stays the same while writers continue):
+*
+*   find(T), inOrder(), inOrder(visit), bfs(), bfs(visit), begin()/end(),
+*   size(), getHeight(), empty()
+*
+* Nodes are never changed once published. An insert copies the nodes on
+* the path from the root to the new node (path copying), sharing every
+* other subtree with the previous version, then publishes the new root
+* with a single atomic store. A reader loads the root once and sees one
+* complete version for as long as it likes.
+*
+* Notes:
+*  (1) The tree is kept AVL balanced. Rotations on the insert path also
+*      build new nodes, so a version is never modified.
+*  (2) Replaced nodes are freed by epoch based reclamation. Each thread
+*      has an epoch record. A reader stores the global epoch in its
+*      record (pins) before loading the root, and clears it when done. A
+*      writer advances the global epoch after publishing a root, tags the
+*      nodes it replaced with the new epoch, and frees them once every
+*      pinned reader has an epoch at least that new (so loaded a root
+*      without them). Pinning is a load and a store, wait-free.
+*  (3) A snapshot pins its thread, holding back reclamation (never
+*      writers) while it lives. Snapshots must be destroyed by the thread
+*      which took them, and before the tree.
+*  (4) Writers hold a mutex, and allocate and free nodes from a pool
+*      (pool.h) under it. There is no remove, chains only grow.
+*  (5) Equal items are added to the right, as in Tree<T>.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Added retired and reclaimed node counts. JME
+*************************************************************************/
+#ifndef _CONCURRENT_TREE_H_
+#define _CONCURRENT_TREE_H_
+
+#include <algorithm> // max, min, remove
+#include <atomic>    // root, epochs
+#include <cstddef>   // size_t
+#include <cstdint>   // uint64_t
+#include <iostream>  // cout
+#include <iterator>  // iterator tags
+#include <mutex>     // writers, epoch registry
+#include <vector>    // epoch registry
+#include "pool.h"    // node pool
+#include "queue.h"   // bfs traversal, retired nodes
+#include "vector.h"  // traversal stacks
+
+namespace myTree {
+
+	// Epoch of a thread which isn't reading.
+	constexpr uint64_t IDLE_EPOCH = UINT64_MAX;
+	// Retired nodes a writer collects before trying to free them.
+	constexpr std::size_t RECLAIM_THRESHOLD = 256;
+
+	class EpochRecord;
+
+	// Epoch records of all threads.
+	struct EpochRegistry
+	{
+		std::mutex lock;
+		std::vector<const EpochRecord*> live;
+	};
+
+	inline EpochRegistry& epochRegistry()
+	{
+		static EpochRegistry r;
+		return r;
+	}
+
+	// Advanced by writers after each publish.
+	inline std::atomic<uint64_t> globalEpoch{ 1 };
+
+	// One thread's pinned epoch.
+	class EpochRecord
+	{
+		std::atomic<uint64_t> epoch{ IDLE_EPOCH };
+		unsigned int depth = 0; // Nested pins, only the outermost sets epoch.
+
+	public:
+		EpochRecord()
+		{
+			std::lock_guard<std::mutex> guard(epochRegistry().lock);
+			epochRegistry().live.push_back(this);
+		}
+		~EpochRecord()
+		{
+			EpochRegistry& r = epochRegistry();
+			std::lock_guard<std::mutex> guard(r.lock);
+			r.live.erase(std::remove(r.live.begin(), r.live.end(), this), r.live.end());
+		}
+
+		EpochRecord(const EpochRecord&) = delete;
+		EpochRecord& operator= (const EpochRecord&) = delete;
+
+		// Only called by owning thread.
+		void pin()
+		{
+			if (depth++ == 0)
+				epoch.store(globalEpoch.load());
+		}
+		void unpin()
+		{
+			if (--depth == 0)
+				epoch.store(IDLE_EPOCH);
+		}
+
+		uint64_t pinned() const { return epoch.load(); }
+	};
+
+	inline thread_local EpochRecord epochRecord;
+
+	// Oldest epoch pinned by any thread (IDLE_EPOCH if none).
+	inline uint64_t oldestPinnedEpoch()
+	{
+		EpochRegistry& r = epochRegistry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		uint64_t oldest = IDLE_EPOCH;
+
+		for (auto record : r.live)
+			oldest = std::min(oldest, record->pinned());
+		return oldest;
+	}
+
+	template <class T>
+	class ConcurrentTree
+	{
+	private:
+		struct Node
+		{
+			T data;
+			const Node *left;
+			const Node *right;
+			int level;         // Height of subtree rooted here (leaf = 1).
+			std::size_t count; // Nodes in subtree.
+
+			static int height(const Node *node) { return node ? node->level : 0; }
+			static std::size_t size(const Node *node) { return node ? node->count : 0; }
+		};
+
+		// Node replaced by a version, freed once no reader can reach it.
+		struct Retired
+		{
+			Node *node;
+			uint64_t epoch; // First epoch whose readers can't see it.
+		};
+
+		std::atomic<const Node*> root;
+		mutable std::mutex writeLock;
+		myPool::Pool<Node> pool;                            // Writers only.
+		myQueue::Queue<Retired, myQueue::GROWABLE> retired; // Writers only, oldest first.
+		std::size_t retiredCount;
+		std::size_t reclaimedCount;
+		myVector::Vector<Node*> replaced;                   // Nodes replaced by current insert.
+
+		const Node* makeNode(const T& data, const Node *left, const Node *right)
+		{
+			return pool.allocate(Node{ data, left, right, std::max(Node::height(left), Node::height(right)) + 1,
+				Node::size(left) + Node::size(right) + 1 });
+		}
+
+		void replace(const Node *node) { replaced.push_back(const_cast<Node*>(node)); }
+
+		// New node (data, left, right), rotated if subtree heights differ by more than 1.
+		const Node* balance(const T& data, const Node *left, const Node *right)
+		{
+			if (Node::height(left) > Node::height(right) + 1)
+			{
+				replace(left);
+				if (Node::height(left->left) >= Node::height(left->right))
+					// Right rotation.
+					return makeNode(left->data, left->left, makeNode(data, left->right, right));
+				// Left-right rotation.
+				const Node *lr = left->right;
+				replace(lr);
+				return makeNode(lr->data, makeNode(left->data, left->left, lr->left), makeNode(data, lr->right, right));
+			}
+			if (Node::height(right) > Node::height(left) + 1)
+			{
+				replace(right);
+				if (Node::height(right->right) >= Node::height(right->left))
+					// Left rotation.
+					return makeNode(right->data, makeNode(data, left, right->left), right->right);
+				// Right-left rotation.
+				const Node *rl = right->left;
+				replace(rl);
+				return makeNode(rl->data, makeNode(data, left, rl->left), makeNode(right->data, rl->right, right->right));
+			}
+			return makeNode(data, left, right);
+		}
+
+		// Copy of subtree with data inserted, or node itself if not inserted
+		// (unique and data already exists). Recursion depth is the AVL height.
+		const Node* insert(const Node *node, const T& data, bool unique, bool& inserted)
+		{
+			if (!node)
+			{
+				inserted = true;
+				return makeNode(data, nullptr, nullptr);
+			}
+
+			const Node *left = node->left, *right = node->right;
+
+			if (data < node->data)
+				left = insert(node->left, data, unique, inserted);
+			else if (unique && node->data == data)
+				return node;
+			else
+				right = insert(node->right, data, unique, inserted);
+
+			if (!inserted)
+				return node;
+			replace(node);
+			return balance(node->data, left, right);
+		}
+
+		bool insert(const T& data, bool unique)
+		{
+			std::lock_guard<std::mutex> guard(writeLock);
+			bool inserted = false;
+
+			replaced.clear();
+			const Node *newRoot = insert(root.load(), data, unique, inserted);
+			if (!inserted)
+				return false;
+
+			// Publish, then readers pinning the new epoch only see the new root.
+			root.store(newRoot);
+			const uint64_t epoch = globalEpoch.fetch_add(1) + 1;
+
+			for (std::size_t i = 0; i < replaced.size(); i++)
+				retired.enqueue(Retired{ replaced[i], epoch });
+			retiredCount += replaced.size();
+			if (retiredCount >= RECLAIM_THRESHOLD)
+				reclaim();
+			return true;
+		}
+
+		// Free retired nodes no pinned reader can reach.
+		void reclaim()
+		{
+			const uint64_t oldest = oldestPinnedEpoch();
+
+			while (!retired.empty() && retired.front().epoch <= oldest)
+			{
+				pool.release(retired.front().node);
+				retired.dequeue();
+				retiredCount--;
+				reclaimedCount++;
+			}
+		}
+
+		static bool find(const Node *node, const T& data)
+		{
+			while (node)
+			{
+				if (data < node->data)
+					node = node->left;
+				else if (node->data == data)
+					return true;
+				else
+					node = node->right;
+			}
+			return false;
+		}
+
+	public:
+		// Read-only view of one version of the tree.
+		class Snapshot
+		{
+		private:
+			const Node *root;
+			bool pinned;
+
+			friend class ConcurrentTree;
+
+			explicit Snapshot(const std::atomic<const Node*>& treeRoot) : pinned(true)
+			{
+				epochRecord.pin();
+				root = treeRoot.load();
+			}
+
+		public:
+			Snapshot(Snapshot&& rhs) : root(rhs.root), pinned(rhs.pinned) { rhs.pinned = false; }
+			~Snapshot()
+			{
+				if (pinned)
+					epochRecord.unpin();
+			}
+
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator= (const Snapshot&) = delete;
+			Snapshot& operator= (Snapshot&&) = delete;
+
+			bool find(const T& data) const { return ConcurrentTree::find(root, data); }
+
+			std::size_t size() const { return Node::size(root); }
+			bool empty() const { return root == nullptr; }
+			int getHeight() const { return Node::height(root); }
+
+			// Dfs in-order traversal, prints elements.
+			void inOrder() const { inOrder([](const T& data) { std::cout << data; }); }
+			// Bfs traversal (top down, left to right), prints elements.
+			void bfs() const { bfs([](const T& data) { std::cout << data; }); }
+
+			// Dfs in-order traversal, calls visit(data) for each node.
+			template <class Visit>
+			void inOrder(Visit visit) const
+			{
+				for (const T& data : *this)
+					visit(data);
+			}
+
+			// Bfs traversal, calls visit(data) for each node.
+			template <class Visit>
+			void bfs(Visit visit) const
+			{
+				myQueue::Queue<const Node*, myQueue::GROWABLE> q;
+
+				if (root)
+					q.enqueue(root);
+				while (!q.empty())
+				{
+					const Node *node = q.front();
+					q.dequeue();
+
+					visit(node->data);
+					if (node->left)
+						q.enqueue(node->left);
+					if (node->right)
+						q.enqueue(node->right);
+				}
+			}
+
+			// In-order iterator, as Tree<T>::const_iterator.
+			class const_iterator
+			{
+			private:
+				myVector::Vector<const Node*> stack;
+
+				void pushLeft(const Node *node)
+				{
+					while (node)
+					{
+						stack.push_back(node);
+						node = node->left;
+					}
+				}
+
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef T value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef const T* pointer;
+				typedef const T& reference;
+
+				const_iterator() = default;
+				const_iterator(const Node *root, int height)
+				{
+					stack.reserve(height);
+					pushLeft(root);
+				}
+
+				reference operator*() const { return stack.back()->data; }
+				pointer operator->() const { return &stack.back()->data; }
+
+				const_iterator& operator++()
+				{
+					const Node *node = stack.back();
+					stack.pop_back();
+					pushLeft(node->right);
+					return *this;
+				}
+				const_iterator operator++(int)
+				{
+					const_iterator tmp(*this);
+					++*this;
+					return tmp;
+				}
+
+				bool operator== (const const_iterator& rhs) const
+				{
+					if (stack.empty() || rhs.stack.empty())
+						return stack.empty() && rhs.stack.empty();
+					return stack.back() == rhs.stack.back();
+				}
+				bool operator!= (const const_iterator& rhs) const { return !(*this == rhs); }
+			};
+			typedef const_iterator iterator;
+
+			const_iterator begin() const { return const_iterator(root, getHeight()); }
+			const_iterator end() const { return const_iterator(); }
+		};
+
+		ConcurrentTree() : root(nullptr), retiredCount(0), reclaimedCount(0) { }
+		~ConcurrentTree() = default;
+
+		ConcurrentTree(const ConcurrentTree&) = delete;
+		ConcurrentTree& operator= (const ConcurrentTree&) = delete;
+
+		// Insert item into tree.
+		void add(const T& data) { insert(data, false); }
+		// Insert item into tree if not already present.
+		bool insertUnique(const T& data) { return insert(data, true); }
+
+		// Current version.
+		Snapshot snapshot() const { return Snapshot(root); }
+
+		bool find(const T& data) const { return snapshot().find(data); }
+		std::size_t size() const { return snapshot().size(); }
+		bool empty() const { return snapshot().empty(); }
+		int getHeight() const { return snapshot().getHeight(); }
+
+		std::size_t retiredNodes() const
+		{
+			std::lock_guard<std::mutex> guard(writeLock);
+			return retiredCount;
+		}
+		std::size_t reclaimedNodes() const
+		{
+			std::lock_guard<std::mutex> guard(writeLock);
+			return reclaimedCount;
+		}
+	};
+}
+
+#endif
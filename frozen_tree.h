@@ -0,0 +1,194 @@
+/*************************************************************************
+* Title: Frozen Tree
+* File: frozen_tree.h
+* Author: James Eli
+* Date: 10/16/2026
+*
+* Read-only snapshot of a myTree::Tree, produced by Tree::freeze(). Keys
+* are stored in Eytzinger order: the breadth-first (bfs) order of a
+* perfectly balanced tree built from the sorted keys. Node i has children
+* 2i and 2i+1, so a search walks down an array instead of chasing
+* pointers, and the top levels share a few cache lines.
+*
+*   find(key)    // returns pointer to first element with key, or nullptr.
+*   at(slot)     // element stored at slot.
+*   index(keyOf) // builds FrozenIndex on a secondary key (ex. block id).
+*   size()       // number of elements.
+*
+* FrozenIndex maps a secondary key to a slot of the frozen tree, using the
+* same layout and search.
+*
+* Notes:
+*  (1) Search is branchless, each level picks a child with a comparison
+*      result instead of a branch, and prefetches the cache line holding
+*      the node's descendants 3-4 levels down.
+*  (2) Keys are stored separately from elements, so a search only touches
+*      key cache lines until the element is found.
+*  (3) Eytzinger layout researched in "Array Layouts for Comparison-Based
+*      Searching", Khuong & Morin, 2017.
+*
+*************************************************************************
+* Change Log:
+*  10/16/2026: Initial release. JME
+*************************************************************************/
+#ifndef _FROZEN_TREE_H_
+#define _FROZEN_TREE_H_
+
+#include <algorithm> // sort
+#include <cstdint>   // uintptr_t
+#include <type_traits> // decay
+#include <utility>   // pair
+#include <vector>    // key/element arrays
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#define FROZEN_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#else
+#define FROZEN_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+namespace myTree {
+
+	// Build Eytzinger ordered copy (1 based) of sorted keys.
+	template <class Key>
+	void eytzingerBuild(const std::vector<Key>& sorted, std::vector<Key>& keys, std::vector<std::size_t>& order)
+	{
+		keys.resize(sorted.size() + 1);
+		order.resize(sorted.size() + 1);
+
+		// In-order walk of implicit tree assigns sorted keys.
+		std::size_t next = 0;
+		std::vector<std::size_t> stack;
+		std::size_t i = 1;
+
+		while (i <= sorted.size() || !stack.empty())
+		{
+			if (i <= sorted.size())
+			{
+				stack.push_back(i);
+				i = 2 * i;
+			}
+			else
+			{
+				i = stack.back();
+				stack.pop_back();
+				keys[i] = sorted[next];
+				order[i] = next++;
+				i = 2 * i + 1;
+			}
+		}
+	}
+
+	// Branchless search, returns position of first key not less than key
+	// (0 if none).
+	template <class Key>
+	std::size_t eytzingerLowerBound(const std::vector<Key>& keys, const Key& key)
+	{
+		// Descendants 3-4 levels down share a cache line.
+		constexpr std::size_t KEYS_PER_LINE = 64 / sizeof(Key) ? 64 / sizeof(Key) : 1;
+		const std::size_t n = keys.size() - 1;
+		const Key* base = keys.data();
+		std::size_t i = 1;
+
+		while (i <= n)
+		{
+			// Prefetch never faults, so address needn't be inside array.
+			FROZEN_PREFETCH(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(base) + i * KEYS_PER_LINE * sizeof(Key)));
+			i = 2 * i + (base[i] < key);
+		}
+
+		// Undo right turns taken after the last left turn.
+		while (i & 1)
+			i >>= 1;
+
+		return i >> 1;
+	}
+
+	// Secondary key to slot index.
+	template <class Key>
+	class FrozenIndex
+	{
+	private:
+		std::vector<Key> keys;           // Keys, Eytzinger order.
+		std::vector<std::size_t> slots;  // Slot of each key.
+
+	public:
+		FrozenIndex() : keys(1), slots(1) { }
+		// Build from (key, slot) pairs.
+		explicit FrozenIndex(std::vector<std::pair<Key, std::size_t>> entries)
+		{
+			std::vector<Key> sorted;
+			std::vector<std::size_t> order;
+
+			std::sort(entries.begin(), entries.end());
+			for (auto& e : entries)
+				sorted.push_back(e.first);
+			eytzingerBuild(sorted, keys, order);
+
+			slots.resize(keys.size());
+			for (std::size_t i = 1; i < keys.size(); i++)
+				slots[i] = entries[order[i]].second;
+		}
+
+		// Return true and slot if key found.
+		bool find(const Key& key, std::size_t& slot) const
+		{
+			std::size_t i = eytzingerLowerBound(keys, key);
+
+			if (i == 0 || key < keys[i])
+				return false;
+			slot = slots[i];
+			return true;
+		}
+
+		std::size_t size() const { return slots.size() - 1; }
+	};
+
+	template <class T, class Key>
+	class FrozenTree
+	{
+	private:
+		std::vector<Key> keys; // Keys, Eytzinger order (keys[0] unused).
+		std::vector<T> data;   // Elements, same order as keys.
+
+	public:
+		// Build from elements and keys in sorted (tree in-order) order.
+		FrozenTree(const std::vector<T>& sorted, const std::vector<Key>& sortedKeys)
+		{
+			std::vector<std::size_t> order;
+
+			eytzingerBuild(sortedKeys, keys, order);
+			data.reserve(sorted.size());
+			for (std::size_t i = 1; i < order.size(); i++)
+				data.push_back(sorted[order[i]]);
+		}
+
+		// Find first element with key.
+		const T* find(const Key& key) const
+		{
+			std::size_t i = eytzingerLowerBound(keys, key);
+
+			return (i == 0 || key < keys[i]) ? nullptr : &data[i - 1];
+		}
+
+		// Element at slot (0 to size() - 1).
+		const T& at(std::size_t slot) const { return data[slot]; }
+
+		std::size_t size() const { return data.size(); }
+
+		// Build index on a secondary key, returning slots of this tree.
+		template <class KeyOf, class IndexKey = std::decay_t<decltype(std::declval<KeyOf>()(std::declval<const T&>()))>>
+		FrozenIndex<IndexKey> index(KeyOf keyOf) const
+		{
+			std::vector<std::pair<IndexKey, std::size_t>> entries;
+
+			entries.reserve(data.size());
+			for (std::size_t i = 0; i < data.size(); i++)
+				entries.emplace_back(keyOf(data[i]), i);
+
+			return FrozenIndex<IndexKey>(std::move(entries));
+		}
+	};
+}
+
+#endif
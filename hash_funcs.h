@@ -1,145 +1,314 @@
-/*************************************************************************
-* Title: Hash Functions.
-* File: hash_funcs.h
-* Author: James Eli
-* Date: 11/12/2018
-*
-* Collection of 3 public domain 32-bit hash functions:
-*   C++ STL Hash function.
-*   FNV-1a 32-bit hash function.
-*   CRC32 32-bit cyclic redundancy check.
-*   SDBM 32-bit function.
-*
-* Notes:
-*  (1) Could not achieve consistent results when using the STL x64 hash
-*      function. The STL hash returns std:size_t (32-bits on x86, and
-*      64-bits on x64). The STL hash exihibtted sluggish performance and
-*      suspect nonce values). So, the STL library hash function and 2
-*      alternative functions are provided. Additional information can be 
-*      found below.
-*  (2) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0
-*  (3) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*   11/12/2018: Initial release. JME
-*************************************************************************/
-#ifndef _HASH_FUNCTIONS_H_
-#define _HASH_FUNCTIONS_H_
-
-#include <cstdint>    // uints
-#include <functional> // STL hash
-#include <string>     // strings
-
-// Hash function pointer typedef.
-typedef uint32_t(*HashFunc)(std::string);
-
-// Function prototypes.
-uint32_t stl_32(std::string);
-uint32_t fnv1a_32(std::string);
-uint32_t crc_32(std::string);
-uint32_t sdbm_32(std::string);
-
-// Hash class with FNV1a algorithm as default function.
-template <HashFunc hf = fnv1a_32>
-struct Hash { uint32_t hashString(std::string s) { return hf(s); } };
-
-/*************************************************************************
- * C++ STL <functional> library hash function.
-*************************************************************************/
-uint32_t stl_32(std::string key)
-{
-	std::hash<std::string> sHash;
-
-	// Returns size_t which is 64-bit under x64.
-	return static_cast<uint32_t>(sHash(key));
-}
-
-/*************************************************************************
- * FowlerNollVo is a non-cryptographic hash function created by Glenn Fowler,
- * Landon Curt Noll, and Kiem-Phong Vo. The FNV hash was designed for fast hash
- * table and checksum use, not cryptography. The core of the FNV-1a hash
- * algorithm is as follows:
- *
- *  hash = offset_basis
- *    for each byte_of_data to be hashed
- *    hash = hash XOR octet_of_data
- *    hash = hash * FNV_prime
- *  return hash
- *
- * The FNV-1a hash parameters are as follows:
- *  - hash is an n bit unsigned integer, where n is the bit length of hash.
- *  - The multiplication is performed modulo 2n where n is the bit length of hash.
- *  - The XOR is performed on the low order octet (8 bits) of hash.
- *  - The FNV_prime is dependent on n, the size of the hash:
- *	 32-bit FNV_prime = 224 + 28 + 0x93 = 16777619 (0x1000193)
- *
- * Part of the magic of FNV is the selection of the FNV_prime for a given sized
- * unsigned integer. Some primes do hash better than other primes for a given integer
- * size. The offset_basis for FNV-1a is dependent on n, the size of the hash:
- *  - 32-bit offset_basis = 2166136261 (0x811C9DC5)
- * 
- * Information researched here: http://www.isthe.com/chongo/tech/comp/fnv/
- *************************************************************************/
-uint32_t fnv1a_32(std::string key)
-{
-	uint32_t hash = 0x811c9dc5;
-	uint32_t prime = 0x1000193;
-
-	for (unsigned int i = 0; i < key.length(); ++i)
-	{
-		uint8_t value = key[i];
-		hash = hash ^ value;
-		hash *= prime;
-	}
-
-	return hash;
-}
-
-/*************************************************************************
- * CRC-32 implementation researched in the paper, "Reversing CRCTheory and 
- * Practice", Stigge, Plotz, etal. May 2006. Copy located here: 
- * http://stigge.org/martin/pub/SAR-PR-2006-05.pdf
- * Additional information, including table generation found in the "Painless 
- * Guide to CRC Error Detection Algorithms", R. Williams, August 1993. Copy 
- * located here: 
- * http://chrisballance.com/wp-content/uploads/2015/10/CRC-Primer.html
- *************************************************************************/
-uint32_t crc_32(std::string key)
-{
-	uint32_t crc = 0xffffffff, i=0;
-	std::size_t len = key.length();
-
-	while (len--)
-	{
-		uint32_t val = (crc ^ key[i++]) & 0xff;
-
-		for (int i = 0; i < 8; i++)
-			val = val & 1 ? (val >> 1) ^ 0xedb88320 : val >> 1;
-		
-		crc = val ^ crc >> 8;
-	}
-
-	return crc ^ 0xffffffff;
-}
-
-/*************************************************************************
- * This is the algorithm used in the open source SDBM project. The hash 
- * function seems to have a good over-all distribution for many different 
- * data sets. Algorithm adapted from Hash Functions, York University, 
- * located here: http://www.cse.yorku.ca/~oz/hash.html
- *************************************************************************/
-uint32_t sdbm_32(std::string key)
-{
-	uint32_t hash = 0;
-
-	for (std::size_t i = 0; i < key.length(); i++)
-		hash = (key[i]) + (hash << 6) + (hash << 16) - hash;
-
-	return hash;
-}
-
+/*************************************************************************
+* Title: Hash Functions.
+* File: hash_funcs.h
+* Author: James Eli
+* Date: 11/12/2018
+*
+* Collection of 3 public domain 32-bit hash functions:
+*   C++ STL Hash function.
+*   FNV-1a 32-bit hash function.
+*   CRC32 32-bit cyclic redundancy check.
+*   SDBM 32-bit function.
+*
+* Notes:
+*  (1) Could not achieve consistent results when using the STL x64 hash
+*      function. The STL hash returns std:size_t (32-bits on x86, and
+*      64-bits on x64). The STL hash exihibtted sluggish performance and
+*      suspect nonce values). So, the STL library hash function and 2
+*      alternative functions are provided. Additional information can be 
+*      found below.
+*  (2) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0
+*  (3) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw gcc-g++ (6.3.0-1).
+*  (4) crc_32 hands inputs of CRC_32_FOLD_SIZE bytes or more to the
+*      PCLMULQDQ folding update in hash_simd.cpp (which uses slicing-by-8
+*      when the CPU lacks PCLMULQDQ), so users of crc_32 link hash_simd.cpp.
+*      Shorter inputs, such as mining messages, always use slicing-by-8.
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*   11/12/2018: Initial release. JME
+*   10/16/2026: Hash functions take (data, length) to avoid string copies.
+*               Functions made inline so header can be shared. JME
+*   10/16/2026: Added incremental (init/update/finalize) hash state. JME
+*   10/16/2026: CRC-32 now table driven (slicing-by-8). JME
+*   10/17/2026: Added hash function identifiers. JME
+*   10/17/2026: String versions and Hash take string views. Added ids of
+*               64 and 256-bit hashers (see hashers.h). JME
+*   10/17/2026: Added double SHA-256 id. JME
+*   10/17/2026: crc_32 dispatches long inputs to PCLMULQDQ folding. JME
+*************************************************************************/
+#ifndef _HASH_FUNCTIONS_H_
+#define _HASH_FUNCTIONS_H_
+
+#include <cstddef>    // size_t
+#include <cstdint>    // uints
+#include <functional> // STL hash
+#include <string>     // strings
+#include <string_view> // string views
+
+// Hash function pointer typedef (data, length).
+typedef uint32_t(*HashFunc)(const char*, std::size_t);
+
+// Function prototypes.
+inline uint32_t stl_32(const char*, std::size_t);
+inline uint32_t fnv1a_32(const char*, std::size_t);
+inline uint32_t crc_32(const char*, std::size_t);
+inline uint32_t sdbm_32(const char*, std::size_t);
+
+// Incremental versions, return state after hashing data.
+inline uint32_t fnv1a_32_update(uint32_t, const char*, std::size_t);
+inline uint32_t crc_32_update(uint32_t, const char*, std::size_t);
+inline uint32_t sdbm_32_update(uint32_t, const char*, std::size_t);
+
+// CRC-32 update folding 64 bytes per step with PCLMULQDQ (hash_simd.cpp).
+uint32_t crc_32_update_pclmul(uint32_t, const char*, std::size_t);
+
+// Initial incremental hash states.
+constexpr uint32_t FNV1A_32_INIT = 0x811c9dc5;
+constexpr uint32_t CRC_32_INIT = 0xffffffff;
+constexpr uint32_t SDBM_32_INIT = 0;
+
+// String versions.
+inline uint32_t stl_32(std::string_view key) { return stl_32(key.data(), key.length()); }
+inline uint32_t fnv1a_32(std::string_view key) { return fnv1a_32(key.data(), key.length()); }
+inline uint32_t crc_32(std::string_view key) { return crc_32(key.data(), key.length()); }
+inline uint32_t sdbm_32(std::string_view key) { return sdbm_32(key.data(), key.length()); }
+
+// Incremental hash state. Copy a state to reuse the hash of a common prefix.
+// Functions without incremental versions (STL) keep a copy of the data and 
+// hash it when finalized.
+template <HashFunc hf>
+struct HashState
+{
+	std::string data;
+
+	void update(const char* key, std::size_t len) { data.append(key, len); }
+	uint32_t finalize() const { return hf(data.data(), data.length()); }
+};
+
+template <>
+struct HashState<fnv1a_32>
+{
+	uint32_t hash = FNV1A_32_INIT;
+
+	void update(const char* key, std::size_t len) { hash = fnv1a_32_update(hash, key, len); }
+	uint32_t finalize() const { return hash; }
+};
+
+template <>
+struct HashState<crc_32>
+{
+	uint32_t crc = CRC_32_INIT;
+
+	void update(const char* key, std::size_t len) { crc = crc_32_update(crc, key, len); }
+	uint32_t finalize() const { return crc ^ 0xffffffff; }
+};
+
+template <>
+struct HashState<sdbm_32>
+{
+	uint32_t hash = SDBM_32_INIT;
+
+	void update(const char* key, std::size_t len) { hash = sdbm_32_update(hash, key, len); }
+	uint32_t finalize() const { return hash; }
+};
+
+// Hash class with FNV1a algorithm as default function.
+template <HashFunc hf = fnv1a_32>
+struct Hash 
+{ 
+	typedef HashState<hf> State;
+
+	uint32_t hashString(std::string_view s) { return hf(s.data(), s.length()); } 
+	uint32_t hashBytes(const char* data, std::size_t len) { return hf(data, len); }
+
+	// Incremental hashing.
+	State init() { return State(); }
+	void update(State& state, const char* data, std::size_t len) { state.update(data, len); }
+	uint32_t finalize(const State& state) { return state.finalize(); }
+};
+
+// Hash function identifiers, saved with data (ex. chain files) hashed by it.
+enum class HashId : uint32_t { Unknown = 0, STL_32 = 1, FNV1A_32 = 2, CRC_32 = 3, SDBM_32 = 4, FNV1A_64 = 5, XXH64 = 6, SHA256 = 7, SHA256D = 8 };
+
+inline HashId hashFuncId(HashFunc hf)
+{
+	if (hf == static_cast<HashFunc>(stl_32))
+		return HashId::STL_32;
+	if (hf == static_cast<HashFunc>(fnv1a_32))
+		return HashId::FNV1A_32;
+	if (hf == static_cast<HashFunc>(crc_32))
+		return HashId::CRC_32;
+	if (hf == static_cast<HashFunc>(sdbm_32))
+		return HashId::SDBM_32;
+	return HashId::Unknown;
+}
+
+/*************************************************************************
+ * C++ STL <functional> library hash function.
+*************************************************************************/
+inline uint32_t stl_32(const char* key, std::size_t len)
+{
+	// Same result as std::hash<std::string>.
+	std::hash<std::string_view> sHash;
+
+	// Returns size_t which is 64-bit under x64.
+	return static_cast<uint32_t>(sHash(std::string_view(key, len)));
+}
+
+/*************************************************************************
+ * FowlerNollVo is a non-cryptographic hash function created by Glenn Fowler,
+ * Landon Curt Noll, and Kiem-Phong Vo. The FNV hash was designed for fast hash
+ * table and checksum use, not cryptography. The core of the FNV-1a hash
+ * algorithm is as follows:
+ *
+ *  hash = offset_basis
+ *    for each byte_of_data to be hashed
+ *    hash = hash XOR octet_of_data
+ *    hash = hash * FNV_prime
+ *  return hash
+ *
+ * The FNV-1a hash parameters are as follows:
+ *  - hash is an n bit unsigned integer, where n is the bit length of hash.
+ *  - The multiplication is performed modulo 2n where n is the bit length of hash.
+ *  - The XOR is performed on the low order octet (8 bits) of hash.
+ *  - The FNV_prime is dependent on n, the size of the hash:
+ *	 32-bit FNV_prime = 224 + 28 + 0x93 = 16777619 (0x1000193)
+ *
+ * Part of the magic of FNV is the selection of the FNV_prime for a given sized
+ * unsigned integer. Some primes do hash better than other primes for a given integer
+ * size. The offset_basis for FNV-1a is dependent on n, the size of the hash:
+ *  - 32-bit offset_basis = 2166136261 (0x811C9DC5)
+ * 
+ * Information researched here: http://www.isthe.com/chongo/tech/comp/fnv/
+ *************************************************************************/
+inline uint32_t fnv1a_32(const char* key, std::size_t len) { return fnv1a_32_update(FNV1A_32_INIT, key, len); }
+
+inline uint32_t fnv1a_32_update(uint32_t hash, const char* key, std::size_t len)
+{
+	uint32_t prime = 0x1000193;
+
+	for (std::size_t i = 0; i < len; ++i)
+	{
+		uint8_t value = key[i];
+		hash = hash ^ value;
+		hash *= prime;
+	}
+
+	return hash;
+}
+
+/*************************************************************************
+ * CRC-32 implementation researched in the paper, "Reversing CRCTheory and 
+ * Practice", Stigge, Plotz, etal. May 2006. Copy located here: 
+ * http://stigge.org/martin/pub/SAR-PR-2006-05.pdf
+ * Additional information, including table generation found in the "Painless 
+ * Guide to CRC Error Detection Algorithms", R. Williams, August 1993. Copy 
+ * located here: 
+ * http://chrisballance.com/wp-content/uploads/2015/10/CRC-Primer.html
+ *************************************************************************/
+inline uint32_t crc_32(const char* key, std::size_t len) { return crc_32_update(CRC_32_INIT, key, len) ^ 0xffffffff; }
+
+// CRC-32 polynomial (reflected).
+constexpr uint32_t CRC_32_POLY = 0xedb88320;
+// Shortest input worth folding with PCLMULQDQ.
+constexpr std::size_t CRC_32_FOLD_SIZE = 64;
+
+// CRC-32 lookup tables, computed at compile time. Table 0 is the classic
+// byte at a time table. Table k gives the CRC of a byte followed by k zero
+// bytes, which lets slicing-by-N look up N bytes independently per step.
+struct Crc32Tables
+{
+	uint32_t table[8][256];
+
+	constexpr Crc32Tables() : table()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t val = i;
+
+			for (int j = 0; j < 8; j++)
+				val = val & 1 ? (val >> 1) ^ CRC_32_POLY : val >> 1;
+			table[0][i] = val;
+		}
+
+		for (int k = 1; k < 8; k++)
+			for (uint32_t i = 0; i < 256; i++)
+				table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff];
+	}
+};
+
+inline constexpr Crc32Tables CRC_32_TABLES;
+
+// Slicing-by-N (4 or 8) CRC-32 update, N bytes per step.
+template <std::size_t N>
+inline uint32_t crc_32_slicing(uint32_t crc, const char* key, std::size_t len)
+{
+	static_assert(N == 4 || N == 8, "slicing-by-4 or slicing-by-8 only");
+
+	const auto& t = CRC_32_TABLES.table;
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(key);
+
+	for (; len >= N; len -= N, p += N)
+	{
+		// First 4 bytes combine with crc (little endian), rest stand alone.
+		crc ^= p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+
+		uint32_t next = t[N - 1][crc & 0xff] ^ t[N - 2][(crc >> 8) & 0xff] 
+			^ t[N - 3][(crc >> 16) & 0xff] ^ t[N - 4][crc >> 24];
+		for (std::size_t i = 4; i < N; i++)
+			next ^= t[N - 1 - i][p[i]];
+
+		crc = next;
+	}
+
+	// Remaining bytes, one at a time.
+	while (len--)
+		crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
+
+inline uint32_t crc_32_update(uint32_t crc, const char* key, std::size_t len)
+{
+	return len >= CRC_32_FOLD_SIZE ? crc_32_update_pclmul(crc, key, len) : crc_32_slicing<8>(crc, key, len);
+}
+
+// Original bit at a time CRC-32 update. Kept as reference.
+inline uint32_t crc_32_update_bitwise(uint32_t crc, const char* key, std::size_t len)
+{
+	uint32_t i = 0;
+
+	while (len--)
+	{
+		uint32_t val = (crc ^ key[i++]) & 0xff;
+
+		for (int i = 0; i < 8; i++)
+			val = val & 1 ? (val >> 1) ^ CRC_32_POLY : val >> 1;
+		
+		crc = val ^ crc >> 8;
+	}
+
+	return crc;
+}
+
+/*************************************************************************
+ * This is the algorithm used in the open source SDBM project. The hash 
+ * function seems to have a good over-all distribution for many different 
+ * data sets. Algorithm adapted from Hash Functions, York University, 
+ * located here: http://www.cse.yorku.ca/~oz/hash.html
+ *************************************************************************/
+inline uint32_t sdbm_32(const char* key, std::size_t len) { return sdbm_32_update(SDBM_32_INIT, key, len); }
+
+inline uint32_t sdbm_32_update(uint32_t hash, const char* key, std::size_t len)
+{
+	for (std::size_t i = 0; i < len; i++)
+		hash = (key[i]) + (hash << 6) + (hash << 16) - hash;
+
+	return hash;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,803 @@
+/*************************************************************************
+* Title: SIMD Hash Functions.
+* File: hash_simd.cpp
+* Author: James Eli
+* Date: 10/16/2026
+*
+* AVX2, SSE2 and scalar multi-lane FNV-1a and SDBM kernels, PCLMULQDQ
+* CRC-32 folding, SHA-NI, AVX2, SSE2 and scalar multi-lane SHA-256, and
+* runtime instruction set selection.
+*
+* Notes:
+*  (1) Lanes shorter than the longest message keep their hash unchanged
+*      (masked blend) once their own bytes are consumed.
+*  (2) FNV-1a zero extends message bytes, SDBM sign extends them (char),
+*      matching the scalar functions.
+*  (3) GCC/Clang compile the SIMD kernels with target attributes, so no
+*      special compiler flags are needed. MSVC needs none either.
+*  (4) CRC-32 folding constants and reduction are from "Fast CRC 
+*      Computation for Generic Polynomials Using PCLMULQDQ Instruction",
+*      Gopal, Ozturk, et al., Intel, December 2009.
+*  (5) SHA-NI also needs SSE4.1 (blend), checked with the SHA feature.
+*
+*************************************************************************
+* Change Log:
+*   10/16/2026: Initial release. JME
+*   10/16/2026: Added PCLMULQDQ CRC-32. JME
+*   10/17/2026: Added SHA-256 lanes. JME
+*   10/17/2026: MSVC detects SSE2 on CPUs without CPUID leaf 7. JME
+*************************************************************************/
+#include <charconv>   // to_chars
+#include <cstring>    // memcpy
+#include "hash_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HASH_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>   // cpuid
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_PCLMUL
+#define TARGET_SHANI
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_PCLMUL __attribute__((target("sse2,pclmul")))
+#define TARGET_SHANI __attribute__((target("sse4.1,sha")))
+#endif
+#endif
+
+// FNV-1a 32-bit prime.
+constexpr uint32_t FNV1A_32_PRIME = 0x1000193;
+
+/*************************************************************************
+ * Instruction set detection.
+*************************************************************************/
+static SimdLevel detectSimdLevel()
+{
+#if defined(HASH_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool sse2 = (info[3] & (1 << 26)) != 0;
+
+	// AVX2 is reported by leaf 7, and also requires OS support for saving
+	// YMM registers.
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		if (osxsave && (info[1] & (1 << 5)) && (_xgetbv(0) & 6) == 6)
+			return SimdLevel::AVX2;
+	}
+	if (sse2)
+		return SimdLevel::SSE2;
+#elif defined(HASH_SIMD_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return SimdLevel::SSE2;
+#endif
+	return SimdLevel::Scalar;
+}
+
+SimdLevel simdLevel()
+{
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+static bool detectPclmul()
+{
+#if defined(HASH_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 1);
+	return (info[2] & (1 << 1)) != 0;
+#elif defined(HASH_SIMD_X86)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("pclmul");
+#else
+	return false;
+#endif
+}
+
+bool hasPclmul()
+{
+	static const bool pclmul = detectPclmul();
+	return pclmul;
+}
+
+static bool detectShaNi()
+{
+#if defined(HASH_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	bool sse41 = (info[2] & (1 << 19)) != 0;
+	__cpuidex(info, 7, 0);
+	return sse41 && (info[1] & (1 << 29));
+#elif defined(HASH_SIMD_X86)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+#else
+	return false;
+#endif
+}
+
+bool hasShaNi()
+{
+	static const bool shaNi = detectShaNi();
+	return shaNi;
+}
+
+Sha256Kernel sha256Kernel()
+{
+	if (hasShaNi())
+		return Sha256Kernel::SHA_NI;
+	switch (simdLevel())
+	{
+	case SimdLevel::AVX2: return Sha256Kernel::AVX2;
+	case SimdLevel::SSE2: return Sha256Kernel::SSE2;
+	default:              return Sha256Kernel::Scalar;
+	}
+}
+
+const char* sha256KernelName(Sha256Kernel kernel)
+{
+	switch (kernel)
+	{
+	case Sha256Kernel::SHA_NI: return "sha-ni";
+	case Sha256Kernel::AVX2:   return "avx2";
+	case Sha256Kernel::SSE2:   return "sse2";
+	default:                   return "scalar";
+	}
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2: return "avx2";
+	case SimdLevel::SSE2: return "sse2";
+	default:              return "scalar";
+	}
+}
+
+/*************************************************************************
+ * Portable scalar kernels (reference).
+*************************************************************************/
+static void fnv1a_32_scalar(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+	{
+		uint32_t hash = state;
+
+		for (std::size_t i = 0; i < m.length[lane]; i++)
+			hash = (hash ^ m.bytes[i * HASH_LANES + lane]) * FNV1A_32_PRIME;
+		out[lane] = hash;
+	}
+}
+
+static void sdbm_32_scalar(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+	{
+		uint32_t hash = state;
+
+		for (std::size_t i = 0; i < m.length[lane]; i++)
+			hash = static_cast<char>(m.bytes[i * HASH_LANES + lane]) + (hash << 6) + (hash << 16) - hash;
+		out[lane] = hash;
+	}
+}
+
+#ifdef HASH_SIMD_X86
+/*************************************************************************
+ * SSE2 kernels, 2 registers of 4 lanes.
+*************************************************************************/
+// Select a where mask set, else b.
+TARGET_SSE2 static inline __m128i blend(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Multiply by FNV prime (0x1000193), SSE2 has no 32-bit multiply low.
+TARGET_SSE2 static inline __m128i mulFnvPrime(__m128i h)
+{
+	__m128i r = _mm_add_epi32(h, _mm_slli_epi32(h, 1));
+	r = _mm_add_epi32(r, _mm_slli_epi32(h, 4));
+	r = _mm_add_epi32(r, _mm_slli_epi32(h, 7));
+	r = _mm_add_epi32(r, _mm_slli_epi32(h, 8));
+	return _mm_add_epi32(r, _mm_slli_epi32(h, 24));
+}
+
+// Load 8 bytes, zero extend to 2 x 4 32-bit lanes.
+TARGET_SSE2 static inline void loadZeroExtend(const uint8_t* p, __m128i& lo, __m128i& hi)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), zero);
+
+	lo = _mm_unpacklo_epi16(v, zero);
+	hi = _mm_unpackhi_epi16(v, zero);
+}
+
+// Load 8 bytes, sign extend to 2 x 4 32-bit lanes.
+TARGET_SSE2 static inline void loadSignExtend(const uint8_t* p, __m128i& lo, __m128i& hi)
+{
+	__m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+
+	v = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+	lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+	hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+
+TARGET_SSE2 static void fnv1a_32_sse2(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	__m128i hLo = _mm_set1_epi32(static_cast<int>(state)), hHi = hLo;
+	__m128i lenLo, lenHi;
+
+	loadZeroExtend(m.length, lenLo, lenHi);
+	for (std::size_t i = 0; i < m.maxLength; i++)
+	{
+		__m128i pos = _mm_set1_epi32(static_cast<int>(i));
+		__m128i dLo, dHi;
+
+		loadZeroExtend(&m.bytes[i * HASH_LANES], dLo, dHi);
+		hLo = blend(_mm_cmpgt_epi32(lenLo, pos), mulFnvPrime(_mm_xor_si128(hLo, dLo)), hLo);
+		hHi = blend(_mm_cmpgt_epi32(lenHi, pos), mulFnvPrime(_mm_xor_si128(hHi, dHi)), hHi);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), hLo);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), hHi);
+}
+
+// SDBM step: d + (h << 6) + (h << 16) - h.
+TARGET_SSE2 static inline __m128i sdbmStep(__m128i h, __m128i d)
+{
+	return _mm_sub_epi32(_mm_add_epi32(_mm_add_epi32(d, _mm_slli_epi32(h, 6)), _mm_slli_epi32(h, 16)), h);
+}
+
+TARGET_SSE2 static void sdbm_32_sse2(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	__m128i hLo = _mm_set1_epi32(static_cast<int>(state)), hHi = hLo;
+	__m128i lenLo, lenHi;
+
+	loadZeroExtend(m.length, lenLo, lenHi);
+	for (std::size_t i = 0; i < m.maxLength; i++)
+	{
+		__m128i pos = _mm_set1_epi32(static_cast<int>(i));
+		__m128i dLo, dHi;
+
+		loadSignExtend(&m.bytes[i * HASH_LANES], dLo, dHi);
+		hLo = blend(_mm_cmpgt_epi32(lenLo, pos), sdbmStep(hLo, dLo), hLo);
+		hHi = blend(_mm_cmpgt_epi32(lenHi, pos), sdbmStep(hHi, dHi), hHi);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), hLo);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), hHi);
+}
+
+/*************************************************************************
+ * AVX2 kernels, 1 register of 8 lanes.
+*************************************************************************/
+TARGET_AVX2 static void fnv1a_32_avx2(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	const __m256i prime = _mm256_set1_epi32(static_cast<int>(FNV1A_32_PRIME));
+	__m256i h = _mm256_set1_epi32(static_cast<int>(state));
+	__m256i len = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(m.length)));
+
+	for (std::size_t i = 0; i < m.maxLength; i++)
+	{
+		__m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m.bytes[i * HASH_LANES])));
+		__m256i mask = _mm256_cmpgt_epi32(len, _mm256_set1_epi32(static_cast<int>(i)));
+
+		h = _mm256_blendv_epi8(h, _mm256_mullo_epi32(_mm256_xor_si256(h, d), prime), mask);
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), h);
+}
+
+TARGET_AVX2 static void sdbm_32_avx2(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+	__m256i h = _mm256_set1_epi32(static_cast<int>(state));
+	__m256i len = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(m.length)));
+
+	for (std::size_t i = 0; i < m.maxLength; i++)
+	{
+		__m256i d = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m.bytes[i * HASH_LANES])));
+		__m256i mask = _mm256_cmpgt_epi32(len, _mm256_set1_epi32(static_cast<int>(i)));
+		__m256i next = _mm256_sub_epi32(_mm256_add_epi32(_mm256_add_epi32(d, _mm256_slli_epi32(h, 6)), _mm256_slli_epi32(h, 16)), h);
+
+		h = _mm256_blendv_epi8(h, next, mask);
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), h);
+}
+
+/*************************************************************************
+ * PCLMULQDQ CRC-32, folds 4 x 128 bits in parallel. Requires len >= 64.
+*************************************************************************/
+// Fold 128 bits x by constants k, and add (xor) y.
+TARGET_PCLMUL static inline __m128i fold(__m128i x, __m128i k, __m128i y)
+{
+	return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), y);
+}
+
+TARGET_PCLMUL static uint32_t crc_32_fold(uint32_t crc, const uint8_t* p, std::size_t len)
+{
+	// Bit reflected constants (x^n mod P) and Barrett reduction constants.
+	const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+	const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+	const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+	const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+	const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+	__m128i x1, x2, x3, x4;
+
+	x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_cvtsi32_si128(static_cast<int>(crc)));
+	x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+	x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+	x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48));
+	p += 64;
+	len -= 64;
+
+	// Parallel fold 64 bytes per step.
+	for (; len >= 64; len -= 64, p += 64)
+	{
+		x1 = fold(x1, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+		x2 = fold(x2, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+		x3 = fold(x3, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+		x4 = fold(x4, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+	}
+
+	// Fold into 128 bits.
+	x1 = fold(x1, k3k4, x2);
+	x1 = fold(x1, k3k4, x3);
+	x1 = fold(x1, k3k4, x4);
+
+	// Fold 16 bytes per step.
+	for (; len >= 16; len -= 16, p += 16)
+		x1 = fold(x1, k3k4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+
+	// Fold 128 bits to 64 bits.
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00), x2);
+
+	// Barrett reduce to 32 bits.
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+	x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	crc = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+
+	// Remaining (< 16) bytes.
+	return crc_32_slicing<8>(crc, reinterpret_cast<const char*>(p), len);
+}
+#endif // End HASH_SIMD_X86.
+
+uint32_t crc_32_update_pclmul(uint32_t crc, const char* key, std::size_t len)
+{
+#ifdef HASH_SIMD_X86
+	if (len >= CRC_32_FOLD_SIZE && hasPclmul())
+		return crc_32_fold(crc, reinterpret_cast<const uint8_t*>(key), len);
+#endif
+	return crc_32_slicing<8>(crc, key, len);
+}
+
+/*************************************************************************
+ * SHA-256 lanes. Each lane's final block(s) are built from the pending
+ * bytes of the state and the lane message, and stored as words by lane
+ * (w[i][lane]), so a single load fetches word i of every lane.
+*************************************************************************/
+// Final blocks of HASH_LANES messages.
+struct Sha256Blocks
+{
+	uint32_t w[2][16][HASH_LANES]; // Words of block 0 and block 1.
+	uint8_t blocks[HASH_LANES];    // Blocks in each lane (1 or 2).
+	bool twoBlocks;                // Some lane has 2 blocks.
+	unsigned int fixedWords;       // Leading words of block 0 same in all lanes.
+};
+
+static inline uint32_t rotr32(uint32_t x, int r) { return x >> r | x << (32 - r); }
+
+// Pad pending bytes + lane message into final block(s) of each lane.
+static void sha256Blocks(const Sha256::State& s, const LaneMessages& m, Sha256Blocks& b)
+{
+	const std::string_view pending = s.pending();
+	const std::size_t fixed = pending.length() / 4; // Words of pending bytes only.
+	uint8_t block[128];
+
+	// Pending bytes are the same in every lane.
+	std::memcpy(block, pending.data(), pending.length());
+	b.twoBlocks = false;
+	b.fixedWords = static_cast<unsigned int>(fixed);
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+	{
+		std::size_t len = pending.length();
+		const std::size_t n = len + m.length[lane] + 9 <= 64 ? 1 : 2;
+
+		std::memset(block + len, 0, n * 64 - len);
+		for (std::size_t i = 0; i < m.length[lane]; i++)
+			block[len++] = m.bytes[i * HASH_LANES + lane];
+		block[len] = 0x80;
+
+		// Bit length, big endian, at end of last block.
+		uint64_t bits = (s.size() + m.length[lane]) * 8;
+		for (int i = 0; i < 8; i++)
+			block[n * 64 - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+
+		b.blocks[lane] = static_cast<uint8_t>(n);
+		b.twoBlocks |= n == 2;
+		for (std::size_t i = lane ? fixed : 0; i < n * 16; i++)
+		{
+			const uint8_t* p = block + 4 * i;
+			b.w[i / 16][i % 16][lane] = static_cast<uint32_t>(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3];
+		}
+		for (std::size_t i = 0; lane && i < fixed; i++)
+			b.w[0][i][lane] = b.w[0][i][0];
+	}
+
+	// Second block of single block lanes is compressed, but not used.
+	for (std::size_t lane = 0; b.twoBlocks && lane < HASH_LANES; lane++)
+		if (b.blocks[lane] == 1)
+			for (std::size_t i = 0; i < 16; i++)
+				b.w[1][i][lane] = 0;
+}
+
+// One round on working variables (a-h), kw is K[i] + w[i].
+static inline void sha256Round(uint32_t v[8], uint32_t kw)
+{
+	uint32_t t1 = v[7] + (rotr32(v[4], 6) ^ rotr32(v[4], 11) ^ rotr32(v[4], 25)) + ((v[4] & v[5]) ^ (~v[4] & v[6])) + kw;
+	uint32_t t2 = (rotr32(v[0], 2) ^ rotr32(v[0], 13) ^ rotr32(v[0], 22)) + ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+
+	for (int i = 7; i > 0; i--)
+		v[i] = v[i - 1];
+	v[4] += t1;
+	v[0] = t1 + t2;
+}
+
+// Compress block of each lane into state. If rounds isn't 0, the first
+// rounds are already done, and start holds the working variables after
+// them (same in all lanes).
+static void sha256_scalar(uint32_t state[8][HASH_LANES], const uint32_t w[16][HASH_LANES], const uint32_t start[8], unsigned int rounds)
+{
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+	{
+		uint32_t x[64], v[8];
+
+		for (int i = 0; i < 16; i++)
+			x[i] = w[i][lane];
+		for (int i = 16; i < 64; i++)
+			x[i] = x[i - 16] + (rotr32(x[i - 15], 7) ^ rotr32(x[i - 15], 18) ^ x[i - 15] >> 3) + x[i - 7]
+				+ (rotr32(x[i - 2], 17) ^ rotr32(x[i - 2], 19) ^ x[i - 2] >> 10);
+		for (int i = 0; i < 8; i++)
+			v[i] = rounds ? start[i] : state[i][lane];
+
+		for (unsigned int i = rounds; i < 64; i++)
+			sha256Round(v, Sha256::K[i] + x[i]);
+		for (int i = 0; i < 8; i++)
+			state[i][lane] += v[i];
+	}
+}
+
+#ifdef HASH_SIMD_X86
+/*************************************************************************
+ * SSE2 SHA-256, 4 lanes per call.
+*************************************************************************/
+TARGET_SSE2 static inline __m128i rotr128(__m128i x, int r) { return _mm_or_si128(_mm_srli_epi32(x, r), _mm_slli_epi32(x, 32 - r)); }
+
+TARGET_SSE2 static void sha256_sse2(uint32_t state[8][HASH_LANES], const uint32_t w[16][HASH_LANES], const uint32_t start[8], 
+	unsigned int rounds, std::size_t lane)
+{
+	__m128i x[16], v[8];
+
+	for (int i = 0; i < 16; i++)
+		x[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&w[i][lane]));
+	for (int i = 0; i < 8; i++)
+		v[i] = rounds ? _mm_set1_epi32(static_cast<int>(start[i])) : _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[i][lane]));
+
+	for (unsigned int i = rounds; i < 64; i++)
+	{
+		// Message schedule, 16 word ring.
+		if (i >= 16)
+		{
+			__m128i w15 = x[(i + 1) & 15], w2 = x[(i + 14) & 15];
+			__m128i s0 = _mm_xor_si128(_mm_xor_si128(rotr128(w15, 7), rotr128(w15, 18)), _mm_srli_epi32(w15, 3));
+			__m128i s1 = _mm_xor_si128(_mm_xor_si128(rotr128(w2, 17), rotr128(w2, 19)), _mm_srli_epi32(w2, 10));
+			x[i & 15] = _mm_add_epi32(_mm_add_epi32(x[i & 15], s0), _mm_add_epi32(x[(i + 9) & 15], s1));
+		}
+
+		__m128i e = v[4], a = v[0];
+		__m128i s1 = _mm_xor_si128(_mm_xor_si128(rotr128(e, 6), rotr128(e, 11)), rotr128(e, 25));
+		__m128i ch = _mm_xor_si128(_mm_and_si128(e, v[5]), _mm_andnot_si128(e, v[6]));
+		__m128i t1 = _mm_add_epi32(_mm_add_epi32(v[7], s1), _mm_add_epi32(ch, _mm_add_epi32(_mm_set1_epi32(static_cast<int>(Sha256::K[i])), x[i & 15])));
+		__m128i s0 = _mm_xor_si128(_mm_xor_si128(rotr128(a, 2), rotr128(a, 13)), rotr128(a, 22));
+		__m128i maj = _mm_or_si128(_mm_and_si128(a, v[1]), _mm_and_si128(v[2], _mm_or_si128(a, v[1])));
+
+		v[7] = v[6], v[6] = v[5], v[5] = v[4], v[4] = _mm_add_epi32(v[3], t1);
+		v[3] = v[2], v[2] = v[1], v[1] = v[0], v[0] = _mm_add_epi32(t1, _mm_add_epi32(s0, maj));
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		__m128i* p = reinterpret_cast<__m128i*>(&state[i][lane]);
+		_mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), v[i]));
+	}
+}
+
+/*************************************************************************
+ * AVX2 SHA-256, 8 lanes.
+*************************************************************************/
+TARGET_AVX2 static inline __m256i rotr256(__m256i x, int r) { return _mm256_or_si256(_mm256_srli_epi32(x, r), _mm256_slli_epi32(x, 32 - r)); }
+
+TARGET_AVX2 static void sha256_avx2(uint32_t state[8][HASH_LANES], const uint32_t w[16][HASH_LANES], const uint32_t start[8], unsigned int rounds)
+{
+	__m256i x[16], v[8];
+
+	for (int i = 0; i < 16; i++)
+		x[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w[i]));
+	for (int i = 0; i < 8; i++)
+		v[i] = rounds ? _mm256_set1_epi32(static_cast<int>(start[i])) : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[i]));
+
+	for (unsigned int i = rounds; i < 64; i++)
+	{
+		// Message schedule, 16 word ring.
+		if (i >= 16)
+		{
+			__m256i w15 = x[(i + 1) & 15], w2 = x[(i + 14) & 15];
+			__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr256(w15, 7), rotr256(w15, 18)), _mm256_srli_epi32(w15, 3));
+			__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr256(w2, 17), rotr256(w2, 19)), _mm256_srli_epi32(w2, 10));
+			x[i & 15] = _mm256_add_epi32(_mm256_add_epi32(x[i & 15], s0), _mm256_add_epi32(x[(i + 9) & 15], s1));
+		}
+
+		__m256i e = v[4], a = v[0];
+		__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr256(e, 6), rotr256(e, 11)), rotr256(e, 25));
+		__m256i ch = _mm256_xor_si256(_mm256_and_si256(e, v[5]), _mm256_andnot_si256(e, v[6]));
+		__m256i t1 = _mm256_add_epi32(_mm256_add_epi32(v[7], s1), _mm256_add_epi32(ch, _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(Sha256::K[i])), x[i & 15])));
+		__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr256(a, 2), rotr256(a, 13)), rotr256(a, 22));
+		__m256i maj = _mm256_or_si256(_mm256_and_si256(a, v[1]), _mm256_and_si256(v[2], _mm256_or_si256(a, v[1])));
+
+		v[7] = v[6], v[6] = v[5], v[5] = v[4], v[4] = _mm256_add_epi32(v[3], t1);
+		v[3] = v[2], v[2] = v[1], v[1] = v[0], v[0] = _mm256_add_epi32(t1, _mm256_add_epi32(s0, maj));
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		__m256i* p = reinterpret_cast<__m256i*>(state[i]);
+		_mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), v[i]));
+	}
+}
+
+/*************************************************************************
+ * SHA-NI SHA-256, one block of one lane. Rounds use the ABEF/CDGH state
+ * layout of sha256rnds2. From "Intel SHA Extensions", Gulley, et al.,
+ * Intel, July 2013.
+*************************************************************************/
+// 4 rounds of message words m.
+TARGET_SHANI static inline void shaniRounds(__m128i& state0, __m128i& state1, __m128i m, const uint32_t* k)
+{
+	__m128i kw = _mm_add_epi32(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(k)));
+
+	state1 = _mm_sha256rnds2_epu32(state1, state0, kw);
+	state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(kw, 0x0e));
+}
+
+TARGET_SHANI static void sha256_shani(uint32_t state[8], const uint32_t w[16])
+{
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);     // CDAB
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b); // EFGH
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0);         // CDGH
+
+	const __m128i abef = state0, cdgh = state1;
+	__m128i m0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+	__m128i m1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 4));
+	__m128i m2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 8));
+	__m128i m3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 12));
+
+	// 16 groups of 4 rounds, 4 groups per step. Later groups schedule their
+	// words from the previous 4 groups (m0-m3).
+	for (int g = 0; g < 16; g += 4)
+	{
+		if (g)
+		{
+			m0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m0, m1), _mm_alignr_epi8(m3, m2, 4)), m3);
+			m1 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m1, m2), _mm_alignr_epi8(m0, m3, 4)), m0);
+			m2 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m2, m3), _mm_alignr_epi8(m1, m0, 4)), m1);
+			m3 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m3, m0), _mm_alignr_epi8(m2, m1, 4)), m2);
+		}
+		shaniRounds(state0, state1, m0, Sha256::K + 4 * g);
+		shaniRounds(state0, state1, m1, Sha256::K + 4 * g + 4);
+		shaniRounds(state0, state1, m2, Sha256::K + 4 * g + 8);
+		shaniRounds(state0, state1, m3, Sha256::K + 4 * g + 12);
+	}
+
+	state0 = _mm_add_epi32(state0, abef);
+	state1 = _mm_add_epi32(state1, cdgh);
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b);               // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xb1);            // DCHG
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, state1, 0xf0));    // DCBA
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+}
+#endif // End HASH_SIMD_X86.
+
+// Compress block of each lane into state, using kernel (see sha256_scalar).
+static void sha256Compress(Sha256Kernel kernel, uint32_t state[8][HASH_LANES], const uint32_t w[16][HASH_LANES], 
+	const uint32_t start[8], unsigned int rounds)
+{
+#ifdef HASH_SIMD_X86
+	switch (kernel)
+	{
+	case Sha256Kernel::SHA_NI:
+		// Skipping leading rounds doesn't fit the 4 round steps.
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		{
+			uint32_t s[8], x[16];
+
+			for (int i = 0; i < 8; i++)
+				s[i] = state[i][lane];
+			for (int i = 0; i < 16; i++)
+				x[i] = w[i][lane];
+			sha256_shani(s, x);
+			for (int i = 0; i < 8; i++)
+				state[i][lane] = s[i];
+		}
+		return;
+
+	case Sha256Kernel::AVX2:
+		return sha256_avx2(state, w, start, rounds);
+
+	case Sha256Kernel::SSE2:
+		sha256_sse2(state, w, start, rounds, 0);
+		return sha256_sse2(state, w, start, rounds, 4);
+
+	default:
+		break;
+	}
+#endif
+	sha256_scalar(state, w, start, rounds);
+}
+
+void sha256_lanes(Sha256Kernel kernel, const Sha256::State& s, const LaneMessages& m, Digest256 out[HASH_LANES], bool twice)
+{
+	Sha256Blocks b;
+	uint32_t state[8][HASH_LANES], start[8];
+	const uint32_t* mid = s.midstate();
+
+	sha256Blocks(s, m, b);
+	for (int i = 0; i < 8; i++)
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			state[i][lane] = mid[i];
+
+	// Rounds of words holding only pending bytes are the same in every lane.
+	std::memcpy(start, mid, sizeof(start));
+	for (unsigned int i = 0; i < b.fixedWords; i++)
+		sha256Round(start, Sha256::K[i] + b.w[0][i][0]);
+
+	sha256Compress(kernel, state, b.w[0], start, b.fixedWords);
+	if (b.twoBlocks)
+	{
+		uint32_t first[8][HASH_LANES];
+
+		std::memcpy(first, state, sizeof(first));
+		sha256Compress(kernel, state, b.w[1], start, 0);
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+			if (b.blocks[lane] == 1)
+				for (int i = 0; i < 8; i++)
+					state[i][lane] = first[i][lane];
+	}
+
+	// Second SHA-256 of 32 byte digest, a single padded block.
+	if (twice)
+	{
+		uint32_t w[16][HASH_LANES];
+
+		for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		{
+			for (int i = 0; i < 8; i++)
+			{
+				w[i][lane] = state[i][lane];
+				state[i][lane] = Sha256::IV[i];
+			}
+			w[8][lane] = 0x80000000;
+			for (int i = 9; i < 15; i++)
+				w[i][lane] = 0;
+			w[15][lane] = 256;
+		}
+		sha256Compress(kernel, state, w, start, 0);
+	}
+
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		for (int i = 0; i < 8; i++)
+			for (int j = 0; j < 4; j++)
+				out[lane].bytes[4 * i + j] = static_cast<uint8_t>(state[i][lane] >> (24 - 8 * j));
+}
+
+void sha256_lanes(const Sha256::State& s, const LaneMessages& m, Digest256 out[HASH_LANES], bool twice) 
+{ 
+	sha256_lanes(sha256Kernel(), s, m, out, twice); 
+}
+
+/*************************************************************************
+ * Kernel dispatch.
+*************************************************************************/
+void fnv1a_32_lanes(SimdLevel level, uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+#ifdef HASH_SIMD_X86
+	if (level == SimdLevel::AVX2)
+		return fnv1a_32_avx2(state, m, out);
+	if (level == SimdLevel::SSE2)
+		return fnv1a_32_sse2(state, m, out);
+#endif
+	fnv1a_32_scalar(state, m, out);
+}
+
+void sdbm_32_lanes(SimdLevel level, uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES])
+{
+#ifdef HASH_SIMD_X86
+	if (level == SimdLevel::AVX2)
+		return sdbm_32_avx2(state, m, out);
+	if (level == SimdLevel::SSE2)
+		return sdbm_32_sse2(state, m, out);
+#endif
+	sdbm_32_scalar(state, m, out);
+}
+
+void fnv1a_32_lanes(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES]) { fnv1a_32_lanes(simdLevel(), state, m, out); }
+void sdbm_32_lanes(uint32_t state, const LaneMessages& m, uint32_t out[HASH_LANES]) { sdbm_32_lanes(simdLevel(), state, m, out); }
+
+/*************************************************************************
+ * Nonce lanes.
+*************************************************************************/
+NonceLanes::NonceLanes(unsigned long n) : first(n)
+{
+	maxLength = 0;
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+		setLane(lane);
+}
+
+void NonceLanes::setLane(std::size_t lane)
+{
+	char digits[MAX_LANE_BYTES];
+	char *end = std::to_chars(digits, digits + MAX_LANE_BYTES, nonce(lane)).ptr;
+
+	length[lane] = static_cast<uint8_t>(end - digits);
+	for (std::size_t i = 0; i < length[lane]; i++)
+		bytes[i * HASH_LANES + lane] = digits[i];
+	if (length[lane] > maxLength)
+		maxLength = length[lane];
+}
+
+// Add HASH_LANES to the decimal digits of each lane. A lane is reformatted
+// only when it gains a digit.
+void NonceLanes::advance()
+{
+	first += HASH_LANES;
+
+	for (std::size_t lane = 0; lane < HASH_LANES; lane++)
+	{
+		unsigned int carry = HASH_LANES;
+
+		for (std::size_t i = length[lane]; carry && i--; )
+		{
+			uint8_t &digit = bytes[i * HASH_LANES + lane];
+			unsigned int d = digit - '0' + carry;
+
+			digit = static_cast<uint8_t>('0' + d % 10);
+			carry = d / 10;
+		}
+
+		if (carry)
+			setLane(lane);
+	}
+}
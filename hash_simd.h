@@ -0,0 +1,140 @@
+/*************************************************************************
+* Title: SIMD Hash Functions.
+* File: hash_simd.h
+* Author: James Eli
+* Date: 10/16/2026
+*
+* Hashes HASH_LANES (8) messages at once with the FNV-1a and SDBM functions
+* from hash_funcs.h. Each lane continues from the same hash state, which
+* makes the kernels suited to hashing many nonces after a common previous
+* hash midstate. Results are bit identical to the scalar functions.
+*
+* Kernels are provided for AVX2 (8 lanes per register), SSE2 (2 x 4 lanes)
+* and portable scalar code. The widest instruction set supported by the CPU
+* is selected at runtime (CPUID).
+*
+* Also provides CRC-32 using carry-less multiply (PCLMULQDQ) folding, which
+* fits the reflected CRC-32 polynomial used by crc_32, and is used by
+* crc_32 for long inputs. Falls back to slicing-by-8 when PCLMULQDQ isn't
+* supported.
+*
+* SHA-256 lanes continue from a shared SHA-256 state (the midstate after
+* the previous hash), so only the final block(s) holding each nonce are
+* compressed. Double SHA-256 then hashes each 32 byte digest, a single
+* block with fixed padding. Kernels: SHA-NI (Intel SHA extensions, one
+* lane at a time), AVX2 (8 lanes), SSE2 (2 x 4 lanes) and scalar. Words
+* of the final block which hold only previous hash bytes are the same in
+* every lane, so their rounds are computed once (multi-buffer kernels).
+*
+* Notes:
+*  (1) Messages are stored by byte position, bytes[i * HASH_LANES + lane],
+*      so a single load fetches byte i of every lane.
+*  (2) NonceLanes holds the decimal digits of 8 consecutive nonces, and
+*      advances them without reformatting each nonce.
+*  (3) The SSE4.2 crc32 instruction computes CRC-32C (Castagnoli), a
+*      different polynomial, so it can't be used for crc_32.
+*  (4) SHA-256 kernel results are checked against Sha256 (hashers.h) and
+*      the FIPS 180-4 test vectors by bench_hash.
+*
+*************************************************************************
+* Change Log:
+*   10/16/2026: Initial release. JME
+*   10/16/2026: Added PCLMULQDQ CRC-32. JME
+*   10/17/2026: Added SHA-256 and double SHA-256 lanes. JME
+*   10/17/2026: crc_32 uses PCLMULQDQ folding for long inputs. JME
+*************************************************************************/
+#ifndef _HASH_SIMD_H_
+#define _HASH_SIMD_H_
+
+#include <cstdint>    // uints
+#include <cstddef>    // size_t
+#include "hash_funcs.h"
+#include "hashers.h"
+
+// Number of messages hashed at once.
+constexpr std::size_t HASH_LANES = 8;
+// Maximum message length per lane.
+constexpr std::size_t MAX_LANE_BYTES = 24;
+
+// Instruction set used by multi-lane kernels.
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+// Widest instruction set supported by this CPU (detected once).
+SimdLevel simdLevel();
+// Printable name of instruction set.
+const char* simdLevelName(SimdLevel);
+
+// HASH_LANES messages stored by byte position.
+struct LaneMessages
+{
+	uint8_t bytes[MAX_LANE_BYTES * HASH_LANES]; // Message bytes, by position.
+	uint8_t length[HASH_LANES];                 // Length of each message.
+	std::size_t maxLength;                      // Longest message.
+};
+
+// Hash each lane message continuing from state, using best available or
+// specified instruction set.
+void fnv1a_32_lanes(uint32_t, const LaneMessages&, uint32_t[HASH_LANES]);
+void fnv1a_32_lanes(SimdLevel, uint32_t, const LaneMessages&, uint32_t[HASH_LANES]);
+void sdbm_32_lanes(uint32_t, const LaneMessages&, uint32_t[HASH_LANES]);
+void sdbm_32_lanes(SimdLevel, uint32_t, const LaneMessages&, uint32_t[HASH_LANES]);
+
+// True if CPU supports carry-less multiply (detected once).
+bool hasPclmul();
+
+// crc_32_update_pclmul (declared in hash_funcs.h) folds 64 bytes per step
+// with PCLMULQDQ. Short inputs and the tail use slicing-by-8.
+
+// SHA-256 lane kernels.
+enum class Sha256Kernel { Scalar, SSE2, AVX2, SHA_NI };
+
+// True if CPU supports SHA extensions (detected once).
+bool hasShaNi();
+// Fastest SHA-256 kernel supported by this CPU.
+Sha256Kernel sha256Kernel();
+// Printable name of SHA-256 kernel.
+const char* sha256KernelName(Sha256Kernel);
+
+// SHA-256 of each lane message continuing from state, hashed again if
+// double (SHA-256d), using best available or specified kernel.
+void sha256_lanes(const Sha256::State&, const LaneMessages&, Digest256[HASH_LANES], bool = false);
+void sha256_lanes(Sha256Kernel, const Sha256::State&, const LaneMessages&, Digest256[HASH_LANES], bool = false);
+
+// Decimal digits of HASH_LANES consecutive nonces (first, first + 1, ...).
+class NonceLanes : public LaneMessages
+{
+	unsigned long first; // Nonce in lane 0.
+
+	// Format nonce digits into lane.
+	void setLane(std::size_t);
+
+public:
+	explicit NonceLanes(unsigned long);
+
+	// Nonce held in lane.
+	unsigned long nonce(std::size_t lane) const { return first + lane; }
+
+	// Advance all lanes by HASH_LANES.
+	void advance();
+};
+
+// Multi-lane kernel selection for Hash<hf>. Only available for functions
+// whose finalize() returns the running state.
+template <HashFunc hf>
+struct LaneKernel { static constexpr bool available = false; };
+
+template <>
+struct LaneKernel<fnv1a_32>
+{
+	static constexpr bool available = true;
+	static void hash(const HashState<fnv1a_32>& s, const LaneMessages& m, uint32_t out[HASH_LANES]) { fnv1a_32_lanes(s.hash, m, out); }
+};
+
+template <>
+struct LaneKernel<sdbm_32>
+{
+	static constexpr bool available = true;
+	static void hash(const HashState<sdbm_32>& s, const LaneMessages& m, uint32_t out[HASH_LANES]) { sdbm_32_lanes(s.hash, m, out); }
+};
+
+#endif
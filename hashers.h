@@ -0,0 +1,437 @@
+/*************************************************************************
+* Title: Hashers
+* File: hashers.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Stateless hash functor types, selected at compile time. A hasher names
+* its digest type, and hashes string views in one call or incrementally:
+*
+*   Hasher::digest_type          // uint32_t, uint64_t or Digest256.
+*   Hasher::id                   // HashId saved with hashed data.
+*   Hasher::hash(sv)             // digest of string view.
+*   Hasher::State s;             // incremental state, copy to reuse prefix.
+*   s.update(sv); s.finalize();
+*
+* Hashers provided:
+*   Stl32, Fnv1a32, Crc32, Sdbm32  32-bit functions of hash_funcs.h.
+*   Fnv1a64                        FNV-1a 64-bit.
+*   XxHash64                       xxHash 64-bit (XXH64, seed 0).
+*   Sha256                         SHA-256 (FIPS 180-4).
+*   Sha256d                        Double SHA-256, SHA-256 of SHA-256 digest.
+*
+* Digests are converted to text with digestString() (decimal for integer
+* digests, hex for Digest256), and DifficultyTarget<Digest> tests the
+* leading hex digits of a digest are zero.
+*
+* Notes:
+*  (1) Wider digests make equal hashes (and forged blocks) far less
+*      likely. They don't change duplicate nonces, which come from every
+*      nonce search starting at 0.
+*  (2) Multi-byte values are read little endian (as the xxHash reference
+*      does on x86/x64).
+*  (3) Digest256 is stored big endian, so its leading hex digits are the
+*      high nibbles of the first bytes.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Added Sha256d. SHA-256 state exposes its midstate for
+*               multi-lane kernels (see hash_simd.h). JME
+*************************************************************************/
+#ifndef _HASHERS_H_
+#define _HASHERS_H_
+
+#include <algorithm>   // min
+#include <cstdint>     // uints
+#include <cstring>     // memcpy
+#include <stdexcept>   // out of range
+#include <string>      // to_string
+#include <string_view> // hasher input
+#include <type_traits> // unsigned
+#include "hash_funcs.h"
+
+// 256-bit digest, big endian.
+struct Digest256
+{
+	uint8_t bytes[32];
+
+	bool operator== (const Digest256& rhs) const { return !std::memcmp(bytes, rhs.bytes, sizeof(bytes)); }
+	bool operator!= (const Digest256& rhs) const { return !(*this == rhs); }
+	bool operator< (const Digest256& rhs) const { return std::memcmp(bytes, rhs.bytes, sizeof(bytes)) < 0; }
+};
+
+// Digest text.
+template <class Digest>
+inline std::string digestString(Digest d)
+{
+	static_assert(std::is_unsigned<Digest>::value, "integer digests only");
+	return std::to_string(d);
+}
+
+inline std::string digestString(const Digest256& d)
+{
+	static const char hex[] = "0123456789abcdef";
+	std::string s(sizeof(d.bytes) * 2, '0');
+
+	for (std::size_t i = 0; i < sizeof(d.bytes); i++)
+	{
+		s[2 * i] = hex[d.bytes[i] >> 4];
+		s[2 * i + 1] = hex[d.bytes[i] & 0xf];
+	}
+	return s;
+}
+
+// Test leading hex digits (difficulty) of a digest are zero.
+template <class Digest>
+class DifficultyTarget
+{
+	static_assert(std::is_unsigned<Digest>::value, "integer digests only");
+	static constexpr unsigned int BITS = sizeof(Digest) * 8;
+
+	Digest mask; // Bits which must be zero.
+
+public:
+	explicit DifficultyTarget(unsigned int difficulty)
+	{
+		if (difficulty > BITS / 4)
+			throw std::out_of_range("difficulty exceeds hash width");
+		mask = difficulty ? ~Digest(0) << (BITS - 4 * difficulty) : 0;
+	}
+
+	bool met(Digest h) const { return !(h & mask); }
+};
+
+template <>
+class DifficultyTarget<Digest256>
+{
+	unsigned int difficulty; // Leading zero hex digits.
+
+public:
+	explicit DifficultyTarget(unsigned int d) : difficulty(d)
+	{
+		if (difficulty > 64)
+			throw std::out_of_range("difficulty exceeds hash width");
+	}
+
+	bool met(const Digest256& h) const
+	{
+		unsigned int i = 0;
+
+		for (; i < difficulty / 2; i++)
+			if (h.bytes[i])
+				return false;
+		return !(difficulty & 1) || !(h.bytes[i] >> 4);
+	}
+};
+
+// Hasher of 32-bit hash function from hash_funcs.h.
+template <HashFunc hf, HashId hid>
+struct FuncHasher
+{
+	typedef uint32_t digest_type;
+	static constexpr HashId id = hid;
+
+	struct State : HashState<hf>
+	{
+		using HashState<hf>::update;
+		void update(std::string_view s) { HashState<hf>::update(s.data(), s.length()); }
+	};
+
+	static digest_type hash(std::string_view s) { return hf(s.data(), s.length()); }
+};
+
+typedef FuncHasher<stl_32, HashId::STL_32> Stl32;
+typedef FuncHasher<fnv1a_32, HashId::FNV1A_32> Fnv1a32;
+typedef FuncHasher<crc_32, HashId::CRC_32> Crc32;
+typedef FuncHasher<sdbm_32, HashId::SDBM_32> Sdbm32;
+
+/*************************************************************************
+ * FNV-1a 64-bit. Same algorithm as fnv1a_32, with 64-bit parameters:
+ *  - 64-bit offset_basis = 14695981039346656037 (0xCBF29CE484222325)
+ *  - 64-bit FNV_prime = 2^40 + 2^8 + 0xb3 = 1099511628211 (0x100000001B3)
+ *************************************************************************/
+struct Fnv1a64
+{
+	typedef uint64_t digest_type;
+	static constexpr HashId id = HashId::FNV1A_64;
+
+	struct State
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+
+		void update(std::string_view s)
+		{
+			for (unsigned char c : s)
+			{
+				hash ^= c;
+				hash *= 0x100000001b3;
+			}
+		}
+		digest_type finalize() const { return hash; }
+	};
+
+	static digest_type hash(std::string_view s)
+	{
+		State state;
+
+		state.update(s);
+		return state.finalize();
+	}
+};
+
+/*************************************************************************
+ * xxHash 64-bit (XXH64), by Yann Collet. Four accumulators each consume
+ * 8 bytes of every 32 byte stripe, then are merged, and the remaining
+ * bytes and length are mixed in and avalanched. Specification located
+ * here: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ *************************************************************************/
+struct XxHash64
+{
+	typedef uint64_t digest_type;
+	static constexpr HashId id = HashId::XXH64;
+
+	static constexpr uint64_t PRIME_1 = 0x9e3779b185ebca87;
+	static constexpr uint64_t PRIME_2 = 0xc2b2ae3d27d4eb4f;
+	static constexpr uint64_t PRIME_3 = 0x165667b19e3779f9;
+	static constexpr uint64_t PRIME_4 = 0x85ebca77c2b2ae63;
+	static constexpr uint64_t PRIME_5 = 0x27d4eb2f165667c5;
+
+	class State
+	{
+		uint64_t acc[4] = { PRIME_1 + PRIME_2, PRIME_2, 0, 0 - PRIME_1 }; // Seed 0.
+		uint8_t buffer[32];     // Partial stripe.
+		std::size_t buffered = 0;
+		uint64_t length = 0;    // Total bytes.
+
+		void stripe(const uint8_t* p)
+		{
+			for (int i = 0; i < 4; i++)
+				acc[i] = round(acc[i], read64(p + 8 * i));
+		}
+
+	public:
+		void update(std::string_view s)
+		{
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(s.data());
+			std::size_t len = s.length();
+
+			length += len;
+			if (buffered)
+			{
+				std::size_t n = std::min(len, sizeof(buffer) - buffered);
+
+				std::memcpy(buffer + buffered, p, n);
+				buffered += n, p += n, len -= n;
+				if (buffered < sizeof(buffer))
+					return;
+				stripe(buffer);
+				buffered = 0;
+			}
+			for (; len >= 32; len -= 32, p += 32)
+				stripe(p);
+			std::memcpy(buffer, p, len);
+			buffered = len;
+		}
+
+		digest_type finalize() const
+		{
+			uint64_t h;
+
+			if (length >= 32)
+			{
+				h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+				for (int i = 0; i < 4; i++)
+					h = (h ^ round(0, acc[i])) * PRIME_1 + PRIME_4;
+			}
+			else
+				h = PRIME_5;
+			h += length;
+
+			const uint8_t* p = buffer;
+			std::size_t len = buffered;
+
+			for (; len >= 8; len -= 8, p += 8)
+				h = rotl(h ^ round(0, read64(p)), 27) * PRIME_1 + PRIME_4;
+			if (len >= 4)
+			{
+				h = rotl(h ^ read32(p) * PRIME_1, 23) * PRIME_2 + PRIME_3;
+				len -= 4, p += 4;
+			}
+			while (len--)
+				h = rotl(h ^ *p++ * PRIME_5, 11) * PRIME_1;
+
+			// Avalanche.
+			h ^= h >> 33;
+			h *= PRIME_2;
+			h ^= h >> 29;
+			h *= PRIME_3;
+			return h ^ h >> 32;
+		}
+	};
+
+	static digest_type hash(std::string_view s)
+	{
+		State state;
+
+		state.update(s);
+		return state.finalize();
+	}
+
+private:
+	static uint64_t rotl(uint64_t x, int r) { return x << r | x >> (64 - r); }
+	static uint64_t round(uint64_t acc, uint64_t input) { return rotl(acc + input * PRIME_2, 31) * PRIME_1; }
+	static uint64_t read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+	static uint64_t read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; }
+};
+
+/*************************************************************************
+ * SHA-256, as specified in FIPS 180-4, "Secure Hash Standard". Message is
+ * padded to a multiple of 64 byte blocks, and each block is compressed
+ * into 8 words of state by 64 rounds. Copy located here:
+ * https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.180-4.pdf
+ *************************************************************************/
+struct Sha256
+{
+	typedef Digest256 digest_type;
+	static constexpr HashId id = HashId::SHA256;
+
+	// Initial hash value.
+	static constexpr uint32_t IV[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+	// Round constants.
+	static constexpr uint32_t K[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+	};
+
+	class State
+	{
+		uint32_t h[8] = { IV[0], IV[1], IV[2], IV[3], IV[4], IV[5], IV[6], IV[7] };
+		uint8_t buffer[64];     // Partial block.
+		std::size_t buffered = 0;
+		uint64_t length = 0;    // Total bytes.
+
+	public:
+		void update(std::string_view s)
+		{
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(s.data());
+			std::size_t len = s.length();
+
+			length += len;
+			if (buffered)
+			{
+				std::size_t n = std::min(len, sizeof(buffer) - buffered);
+
+				std::memcpy(buffer + buffered, p, n);
+				buffered += n, p += n, len -= n;
+				if (buffered < sizeof(buffer))
+					return;
+				compress(h, buffer);
+				buffered = 0;
+			}
+			for (; len >= 64; len -= 64, p += 64)
+				compress(h, p);
+			std::memcpy(buffer, p, len);
+			buffered = len;
+		}
+
+		digest_type finalize() const
+		{
+			uint32_t state[8];
+			uint8_t block[128] = {};
+			// Padding: 0x80, zeros, then bit length (big endian) in last 8 bytes.
+			std::size_t blocks = buffered < 56 ? 1 : 2;
+			uint64_t bits = length * 8;
+
+			std::memcpy(state, h, sizeof(state));
+			std::memcpy(block, buffer, buffered);
+			block[buffered] = 0x80;
+			for (int i = 0; i < 8; i++)
+				block[blocks * 64 - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+			for (std::size_t i = 0; i < blocks; i++)
+				compress(state, block + 64 * i);
+
+			digest_type d;
+			for (int i = 0; i < 8; i++)
+				for (int j = 0; j < 4; j++)
+					d.bytes[4 * i + j] = static_cast<uint8_t>(state[i] >> (24 - 8 * j));
+			return d;
+		}
+
+		// Midstate (state after all complete blocks), bytes of the partial
+		// block, and total bytes.
+		const uint32_t* midstate() const { return h; }
+		std::string_view pending() const { return std::string_view(reinterpret_cast<const char*>(buffer), buffered); }
+		uint64_t size() const { return length; }
+	};
+
+	static digest_type hash(std::string_view s)
+	{
+		State state;
+
+		state.update(s);
+		return state.finalize();
+	}
+
+	// Compress 64 byte block into state.
+	static void compress(uint32_t state[8], const uint8_t* block)
+	{
+		uint32_t w[64];
+
+		// Message schedule.
+		for (int i = 0; i < 16; i++)
+			w[i] = static_cast<uint32_t>(block[4 * i]) << 24 | block[4 * i + 1] << 16 | block[4 * i + 2] << 8 | block[4 * i + 3];
+		for (int i = 16; i < 64; i++)
+		{
+			uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ w[i - 15] >> 3;
+			uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ w[i - 2] >> 10;
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+		for (int i = 0; i < 64; i++)
+		{
+			uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+			uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+			h = g, g = f, f = e, e = d + t1;
+			d = c, c = b, b = a, a = t1 + t2;
+		}
+
+		state[0] += a, state[1] += b, state[2] += c, state[3] += d;
+		state[4] += e, state[5] += f, state[6] += g, state[7] += h;
+	}
+
+private:
+	static uint32_t rotr(uint32_t x, int r) { return x >> r | x << (32 - r); }
+};
+
+// Double SHA-256 (as Bitcoin block hashes), SHA-256 of the SHA-256 digest.
+struct Sha256d
+{
+	typedef Digest256 digest_type;
+	static constexpr HashId id = HashId::SHA256D;
+
+	struct State
+	{
+		Sha256::State inner; // First SHA-256.
+
+		void update(std::string_view s) { inner.update(s); }
+		digest_type finalize() const { return rehash(inner.finalize()); }
+	};
+
+	static digest_type hash(std::string_view s) { return rehash(Sha256::hash(s)); }
+
+	// SHA-256 of digest.
+	static digest_type rehash(const Digest256& d) { return Sha256::hash(std::string_view(reinterpret_cast<const char*>(d.bytes), sizeof(d.bytes))); }
+};
+
+#endif
@@ -0,0 +1,152 @@
+/*************************************************************************
+* Title: MPMC Queue
+* File: mpmc_queue.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Bounded, lock-free, multi-producer/multi-consumer queue. Any number of
+* threads may enqueue and dequeue at once, ex. mining threads handing
+* blocks to a thread which adds them to a tree and chain file.
+*
+*   tryEnqueue(val)  // returns false if queue full.
+*   tryDequeue(val)  // returns false if queue empty.
+*   enqueue(val)     // waits (yields) while queue full.
+*   dequeue(val)     // waits (yields) while queue empty.
+*
+* Notes:
+*  (1) Ring buffer of cells, each with a sequence number telling whether
+*      it is ready to be written or read for the current lap around the
+*      ring. A thread claims a cell by advancing head (or tail) with a
+*      compare and swap, then writes (reads) the cell and publishes its
+*      new sequence number. Algorithm from "Bounded MPMC queue", Dmitry
+*      Vyukov, 1024cores.net.
+*  (2) Head and tail indices sit on separate cache lines, so producers
+*      and consumers don't invalidate each other's line on every update.
+*  (3) QUEUE_SIZE must be a power of 2.
+*  (4) See queue.h for the single-threaded queue.
+*
+*************************************************************************
+* Change Log:
+*  10/17/2026: Initial release. JME
+*************************************************************************/
+#ifndef _MPMC_QUEUE_H_
+#define _MPMC_QUEUE_H_
+
+#include <atomic>  // sequence numbers, indices
+#include <cstddef> // size_t
+#include <memory>  // smart pointer
+#include <thread>  // yield
+#include <utility> // move
+
+namespace myQueue
+{
+	// Cache line size, for padding shared indices.
+	constexpr std::size_t CACHE_LINE_SIZE = 64;
+	// Default size of MPMC queue if not specified during instantiation.
+	constexpr std::size_t DEFAULT_MPMC_QUEUE_SIZE = 1024;
+
+	template<class T, std::size_t QUEUE_SIZE = DEFAULT_MPMC_QUEUE_SIZE>
+	class MpmcQueue
+	{
+		static_assert(QUEUE_SIZE >= 2 && (QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "queue size must be a power of 2");
+
+	private:
+		struct Cell
+		{
+			std::atomic<std::size_t> sequence; // Lap/ready state of cell.
+			T data;
+		};
+
+		static constexpr std::size_t MASK = QUEUE_SIZE - 1;
+
+		std::unique_ptr<Cell[]> cells;                          // Ring buffer.
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail; // Next position to enqueue.
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head; // Next position to dequeue.
+
+	public:
+		MpmcQueue() : cells(std::make_unique<Cell[]>(QUEUE_SIZE)), tail(0), head(0)
+		{
+			for (std::size_t i = 0; i < QUEUE_SIZE; i++)
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		~MpmcQueue() = default;
+
+		MpmcQueue(const MpmcQueue&) = delete;
+		MpmcQueue& operator= (const MpmcQueue&) = delete;
+
+		bool tryEnqueue(const T& val)
+		{
+			std::size_t pos = tail.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			for (;;)
+			{
+				cell = &cells[pos & MASK];
+				std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+				std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+				if (diff == 0)
+				{
+					// Cell free this lap, try to claim it.
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false; // Cell still holds previous lap's element, queue full.
+				else
+					pos = tail.load(std::memory_order_relaxed);
+			}
+
+			cell->data = val;
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool tryDequeue(T& val)
+		{
+			std::size_t pos = head.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			for (;;)
+			{
+				cell = &cells[pos & MASK];
+				std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+				std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+				if (diff == 0)
+				{
+					// Cell written this lap, try to claim it.
+					if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false; // Cell not yet written, queue empty.
+				else
+					pos = head.load(std::memory_order_relaxed);
+			}
+
+			val = std::move(cell->data);
+			// Free cell for next lap.
+			cell->sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
+			return true;
+		}
+
+		void enqueue(const T& val)
+		{
+			while (!tryEnqueue(val))
+				std::this_thread::yield();
+		}
+
+		void dequeue(T& val)
+		{
+			while (!tryDequeue(val))
+				std::this_thread::yield();
+		}
+
+		// Approximate while other threads are using the queue.
+		bool empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_relaxed); }
+		static constexpr std::size_t capacity() { return QUEUE_SIZE; }
+	};
+}
+
+#endif
@@ -0,0 +1,292 @@
+/*************************************************************************
+* Title: Mining Pipeline
+* File: pipeline.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Mines a chain of blocks with downstream work overlapped on separate
+* threads. Mining is sequential along the chain (block i + 1 needs the
+* hash of block i), but checking, indexing and saving a block are not, so
+* each is a stage connected to the next by a bounded queue:
+*
+*   miner -> validator -> indexer -> writer
+*
+*   miner       mines block i (calling thread).
+*   validator   checks id, hash, difficulty and previous hash link.
+*   indexer     adds block to tree (if nonce doesn't already exist), and
+*               to optional id/hash index (block_index.h).
+*   writer      appends block to chain file, prints progress.
+*
+*   minePipelined(tree, chain, count, difficulty, threads, progress, index)
+*
+* Returns per stage blocks processed, busy time and utilisation (busy
+* time over pipeline wall time), showing which stage is the bottleneck.
+*
+* Notes:
+*  (1) A stage never waits on the stage after it. When an output queue is
+*      full, blocks wait in a growable backlog owned by the producing
+*      stage, and are moved to the queue on its next push. A stage only
+*      waits for its backlog to drain after its last block.
+*  (2) The first exception thrown by any stage (ex. a block failing
+*      validation) stops mining. Later stages discard what is left in
+*      their queues, and the exception is rethrown by minePipelined().
+*  (3) The genesis block (id 0) is saved and indexed, but not added to the
+*      tree.
+*  (4) Tree, index and chain writer are only used by their own stage, and are
+*      free for the caller again once minePipelined() returns.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: Indexer stage maintains optional BlockIndex. JME
+*************************************************************************/
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include <algorithm> // max
+#include <atomic>    // failure flag, closed flag
+#include <chrono>    // busy time
+#include <cstddef>   // size_t
+#include <exception> // exception_ptr
+#include <iomanip>   // manipulators
+#include <mutex>     // first exception
+#include <ostream>   // progress, report
+#include <stdexcept> // runtime_error
+#include <string>    // strings
+#include <thread>    // stage threads
+#include <utility>   // swap
+
+#include "block.h"
+#include "block_index.h"
+#include "chain_file.h"
+#include "chain_validate.h"
+#include "mpmc_queue.h"
+#include "queue.h"
+
+namespace myChain {
+
+	// Size of queue between stages.
+	constexpr std::size_t PIPELINE_QUEUE_SIZE = 64;
+
+	enum PipelineStage { MINER, VALIDATOR, INDEXER, WRITER, STAGES };
+
+	inline const char* stageName(PipelineStage s)
+	{
+		static const char* names[STAGES] = { "miner", "validator", "indexer", "writer" };
+		return names[s];
+	}
+
+	struct StageStats
+	{
+		unsigned long blocks;    // Blocks processed.
+		double busySeconds;      // Time spent on blocks (not waiting for input).
+		double seconds;          // Pipeline wall time.
+		std::size_t peakBacklog; // Most blocks waiting for room in output queue.
+
+		double utilisation() const { return seconds > 0 ? busySeconds / seconds : 0; }
+	};
+
+	struct PipelineStats
+	{
+		StageStats stage[STAGES];
+
+		const StageStats& operator[] (PipelineStage s) const { return stage[s]; }
+	};
+
+	inline std::ostream& operator<< (std::ostream& os, const PipelineStats& p)
+	{
+		os << "    stage  blocks  busy ms   util  backlog\n";
+		for (int s = 0; s < STAGES; s++)
+		{
+			const StageStats& st = p.stage[s];
+
+			os << std::setw(9) << stageName(static_cast<PipelineStage>(s)) << std::setw(8) << st.blocks
+				<< std::fixed << std::setprecision(3) << std::setw(9) << st.busySeconds * 1000
+				<< std::setprecision(1) << std::setw(6) << st.utilisation() * 100 << "%" << std::setw(9) << st.peakBacklog << "\n";
+		}
+		return os;
+	}
+
+	// Queue from one stage to the next. Single producer and consumer.
+	template <class T>
+	class StageQueue
+	{
+		myQueue::MpmcQueue<T, PIPELINE_QUEUE_SIZE> q;
+		myQueue::Queue<T, myQueue::GROWABLE> backlog; // Producer only.
+		std::size_t waiting = 0;                      // Blocks in backlog.
+		std::size_t peak = 0;                         // Most blocks in backlog.
+		std::atomic<bool> closed{ false };
+
+		// Move backlog to queue while there is room.
+		void flush()
+		{
+			while (waiting && q.tryEnqueue(backlog.front()))
+			{
+				backlog.dequeue();
+				waiting--;
+			}
+		}
+
+	public:
+		// Producer: add item, never waits.
+		void push(const T& item)
+		{
+			flush();
+			if (waiting || !q.tryEnqueue(item))
+			{
+				backlog.enqueue(item);
+				peak = std::max(peak, ++waiting);
+			}
+		}
+
+		// Producer: no more items, waits for backlog to drain.
+		void close()
+		{
+			for (flush(); waiting; flush())
+				std::this_thread::yield();
+			closed.store(true, std::memory_order_release);
+		}
+
+		// Consumer: waits for next item, false once queue is closed and empty.
+		bool pop(T& item)
+		{
+			while (!q.tryDequeue(item))
+			{
+				if (closed.load(std::memory_order_acquire))
+					return q.tryDequeue(item);
+				std::this_thread::yield();
+			}
+			return true;
+		}
+
+		std::size_t peakBacklog() const { return peak; }
+	};
+
+	// Mine chain of count blocks from genesis block (tree, chain writer, count,
+	// difficulty, mining threads, optional progress stream, optional id/hash index).
+	template <class TreeType>
+	PipelineStats minePipelined(TreeType& tree, ChainWriter& chain, std::size_t count, unsigned int difficulty,
+		unsigned int threads = 1, std::ostream* progress = nullptr, myIndex::BlockIndex<Block>* blockIndex = nullptr)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		StageQueue<Block> toValidator, toIndexer, toWriter;
+		PipelineStats stats{};
+		std::atomic<bool> failed(false);
+		std::exception_ptr error;
+		std::mutex errorLock;
+
+		// Keep first exception, stop mining.
+		auto fail = [&]()
+		{
+			std::lock_guard<std::mutex> guard(errorLock);
+			if (!error)
+				error = std::current_exception();
+			failed.store(true);
+		};
+
+		// Run work on each block of input queue, then pass it to output queue (if any).
+		auto stage = [&](PipelineStage s, StageQueue<Block>& in, StageQueue<Block>* out, auto work)
+		{
+			StageStats& st = stats.stage[s];
+			Block b;
+
+			while (in.pop(b))
+			{
+				if (failed.load(std::memory_order_relaxed))
+					continue; // Discard.
+
+				auto t0 = Clock::now();
+				try
+				{
+					work(b);
+					if (out)
+						out->push(b);
+				}
+				catch (...)
+				{
+					fail();
+				}
+				st.busySeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+				st.blocks++;
+			}
+
+			if (out)
+			{
+				out->close();
+				st.peakBacklog = out->peakBacklog();
+			}
+		};
+
+		// Validator checks block against the one before it.
+		Block window[2]; // Previous, current.
+		auto validate = [&](const Block& b)
+		{
+			window[1] = b;
+			ChainError e = b.getID() ? checkBlock(window, 1, window[0].getID(), difficulty) : checkBlock(window + 1, 0, 0, difficulty);
+
+			if (e != ChainError::None)
+				throw std::runtime_error("block " + std::to_string(b.getID()) + " failed " + chainErrorName(e) + " check");
+			std::swap(window[0], window[1]);
+		};
+
+		auto index = [&](const Block& b)
+		{
+			if (blockIndex)
+				blockIndex->add(b);
+			if (b.getID())
+				tree.insertUnique(b);
+		};
+
+		auto write = [&](const Block& b)
+		{
+			chain.append(b);
+			if (progress)
+				*progress << "." << std::flush;
+		};
+
+		auto start = Clock::now();
+		std::thread validator([&]() { stage(VALIDATOR, toValidator, &toIndexer, validate); });
+		std::thread indexer([&]() { stage(INDEXER, toIndexer, &toWriter, index); });
+		std::thread writer([&]() { stage(WRITER, toWriter, nullptr, write); });
+
+		// Miner runs on this thread. Previous hash of genesis block is "0".
+		StageStats& mined = stats.stage[MINER];
+		std::string hash("0");
+
+		for (std::size_t i = 0; i < count && !failed.load(std::memory_order_relaxed); i++)
+		{
+			auto t0 = Clock::now();
+			try
+			{
+				Block b(i, hash, 0);
+
+				b.MineBlock(difficulty, threads);
+				hash = b.getHash();
+				toValidator.push(b);
+			}
+			catch (...)
+			{
+				fail();
+			}
+			mined.busySeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+			mined.blocks++;
+		}
+		toValidator.close();
+		mined.peakBacklog = toValidator.peakBacklog();
+
+		validator.join();
+		indexer.join();
+		writer.join();
+
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		for (auto& st : stats.stage)
+			st.seconds = seconds;
+
+		if (error)
+			std::rethrow_exception(error);
+		return stats;
+	}
+}
+
+#endif
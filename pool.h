@@ -0,0 +1,125 @@
+/*************************************************************************
+* Title: Pool
+* File: pool.h
+* Author: James Eli
+* Date: 10/16/2026
+*
+* Object pool allocating from contiguous slabs. Objects are never moved
+* once allocated, so raw pointers to them stay valid until reset.
+*
+*   allocate(T)  // copy (or move) object into pool, returns pointer to it.
+*   release(T*)  // return object to pool for reuse.
+*   reset()      // release all objects, keeps slabs for reuse.
+*   size()       // number of objects in use.
+*
+* Notes:
+*  (1) Released objects stay constructed and are reused by assignment, so
+*      objects in a slab are always constructed up to the high water mark.
+*      reset() only runs destructors for that range, and does nothing more
+*      than reset a counter when T is trivially destructible.
+*  (2) Slabs are only freed when the pool is destroyed.
+*
+*************************************************************************
+* Change Log:
+*  10/16/2026: Initial release. JME
+*  10/17/2026: Added move allocate(). JME
+*************************************************************************/
+#ifndef _POOL_H_
+#define _POOL_H_
+
+#include <memory>      // unique pointer
+#include <new>         // placement new
+#include <type_traits> // trivially destructible
+#include <utility>     // move, forward
+#include <vector>      // slab and free lists
+
+namespace myPool
+{
+	// Default number of objects per slab if not specified during instantiation.
+	constexpr std::size_t DEFAULT_SLAB_SIZE = 4096;
+
+	template<class T, std::size_t SLAB_SIZE = DEFAULT_SLAB_SIZE>
+	class Pool
+	{
+	private:
+		// Uninitialized storage for SLAB_SIZE objects.
+		struct Slab { typename std::aligned_storage<sizeof(T), alignof(T)>::type slot[SLAB_SIZE]; };
+
+		std::vector<std::unique_ptr<Slab>> slabs; // Allocated slabs.
+		std::vector<T*> freeList;                 // Released objects.
+		std::size_t used;                         // Slots constructed (high water mark).
+
+		T* slot(std::size_t i) { return reinterpret_cast<T*>(&slabs[i / SLAB_SIZE]->slot[i % SLAB_SIZE]); }
+
+		// Reuse released object, or construct next slot.
+		template <class V>
+		T* place(V&& val)
+		{
+			if (!freeList.empty())
+			{
+				T* p = freeList.back();
+				freeList.pop_back();
+				*p = std::forward<V>(val);
+				return p;
+			}
+
+			if (used == slabs.size() * SLAB_SIZE)
+				slabs.push_back(std::make_unique<Slab>());
+
+			T* p = new (slot(used)) T(std::forward<V>(val));
+			used++;
+			return p;
+		}
+
+	public:
+		Pool() : used(0) { }
+		~Pool() { reset(); }
+
+		Pool(const Pool&) = delete;
+		Pool& operator= (const Pool&) = delete;
+		Pool(Pool&& rhs) : slabs(std::move(rhs.slabs)), freeList(std::move(rhs.freeList)), used(rhs.used)
+		{
+			rhs.slabs.clear();
+			rhs.freeList.clear();
+			rhs.used = 0;
+		}
+		Pool& operator= (Pool&& rhs)
+		{
+			if (this != &rhs)
+			{
+				reset();
+				slabs = std::move(rhs.slabs);
+				freeList = std::move(rhs.freeList);
+				used = rhs.used;
+				rhs.slabs.clear();
+				rhs.freeList.clear();
+				rhs.used = 0;
+			}
+			return *this;
+		}
+
+		// Copy object into pool.
+		T* allocate(const T& val) { return place(val); }
+		// Move object into pool.
+		T* allocate(T&& val) { return place(std::move(val)); }
+
+		// Return object to pool.
+		void release(T* p) { freeList.push_back(p); }
+
+		// Release all objects.
+		void reset()
+		{
+			if (!std::is_trivially_destructible<T>::value)
+				for (std::size_t i = 0; i < used; i++)
+					slot(i)->~T();
+
+			used = 0;
+			freeList.clear();
+		}
+
+		// Number of objects in use.
+		std::size_t size() const { return used - freeList.size(); }
+	};
+}
+
+#endif
@@ -1,105 +1,132 @@
-/*************************************************************************
-* Title: Queue
-* File: queue.h
-* Author: James Eli
-* Date: 10/26/2018
-*
-* Basic Queue implemented as static circular buffer using a smart pointer.
-*
-* Notes:
-*  (1) Circular buffer concepts researched at Chapter 7. Boost.Circular
-*      Buffer located here:
-*      https://www.boost.org/doc/libs/1_61_0/doc/html/circular_buffer.html
-*  (2) Queue (circular buffer) size is fixed at compile time by QUEUE_SIZE
-*      constant.
-*  (3) Note: when queue (circular buffer) is full, further calls to enqueue
-*      are ignored. Many circular buffers continue by overwriting data.
-*  (4) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
-*  (5) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*  10/21/2018: Initial release. JME
-*  10/26/2018: Added size template parameter.  JME
-*  10/26/2018: Added smart pointer.  JME
-*************************************************************************/
-#ifndef _QUEUE_H_
-#define _QUEUE_H_
-
-#include <exception> // out of range
-#include <memory>    // smart pointer
-
-namespace myQueue
-{
-
-	// Default size of queue array if not specified during instantiation.
-	constexpr std::size_t DEFAULT_QUEUE_SIZE = 16;
-
-	template<class T, std::size_t QUEUE_SIZE = DEFAULT_QUEUE_SIZE>
-	class Queue
-	{
-	private:
-		std::unique_ptr<T[]> data; // Array of queue elements.
-		size_t head;               // Elements popped from this array index.
-		size_t tail;               // Elements pushed to this array index.
-		bool full;                 // True if queue array is full.
-
-	public:
-		Queue() : head(0), tail(0), full(false) { data = std::make_unique<T[]>(QUEUE_SIZE); }
-		~Queue() = default;
-
-		bool enqueue(T val)
-		{
-			if (full)                       // Check if queue full.
-				return false;
-			data[tail] = val;               // Insert value into queue.
-			tail = (tail + 1) % QUEUE_SIZE; // Increment pointer, wrap if necessary.
-			full = (tail == head);          // Queue full?
-			return true;
-		}
-
-		bool dequeue()
-		{
-			if (empty())	                // Check if empty.
-				return false;
-			full = false;                   // Queue can not be full.
-			head = (head + 1) % QUEUE_SIZE; // Increment pointer (wrap if necessary).
-			return true;
-		}
-		/*
-			// Alternative version of dequeue which throws oor exception.
-			T dequeue()
-			{
-				if (empty())
-					throw std::out_of_range("empty queue");
-				T tmp = data[head];
-				full = false;                   // Queue can not be full.
-				head = (head + 1) % QUEUE_SIZE; // Increment pointer (wrap if necessary).
-				return tmp;
-			}
-		*/
-		bool empty() { return (!full && (tail == head)); }
-		bool isFull() { return full; }
-
-		T front()
-		{
-			if (empty())
-				throw std::out_of_range("empty queue");
-			else
-				return data[head];
-		}
-
-		T back()
-		{
-			if (empty())
-				throw std::out_of_range("empty queue");
-			else
-				return data[(tail ? tail - 1 : QUEUE_SIZE - 1)];
-		}
-	};
-}
-
-#endif
+/*************************************************************************
+* Title: Queue
+* File: queue.h
+* Author: James Eli
+* Date: 10/26/2018
+*
+* Basic Queue implemented as static circular buffer using a smart pointer.
+* Instantiated with a size of GROWABLE, the buffer doubles in size when full
+* instead (ex. Queue<T, GROWABLE>).
+*
+* See mpmc_queue.h for a bounded queue shared by multiple threads.
+*
+* Notes:
+*  (1) Circular buffer concepts researched at Chapter 7. Boost.Circular
+*      Buffer located here:
+*      https://www.boost.org/doc/libs/1_61_0/doc/html/circular_buffer.html
+*  (2) Queue (circular buffer) size is fixed at compile time by QUEUE_SIZE
+*      constant.
+*  (3) Note: when fixed size queue (circular buffer) is full, further calls
+*      to enqueue are ignored (return false). Many circular buffers continue
+*      by overwriting data.
+*  (4) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
+*  (5) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*  10/21/2018: Initial release. JME
+*  10/26/2018: Added size template parameter.  JME
+*  10/26/2018: Added smart pointer.  JME
+*  10/17/2026: Added growable mode, const empty/isFull.  JME
+*************************************************************************/
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include <stdexcept> // out of range
+#include <memory>    // smart pointer
+
+namespace myQueue
+{
+
+	// Default size of queue array if not specified during instantiation.
+	constexpr std::size_t DEFAULT_QUEUE_SIZE = 16;
+	// Queue size selecting a growable queue.
+	constexpr std::size_t GROWABLE = 0;
+
+	template<class T, std::size_t QUEUE_SIZE = DEFAULT_QUEUE_SIZE>
+	class Queue
+	{
+	private:
+		std::unique_ptr<T[]> data; // Array of queue elements.
+		size_t capacity;           // Size of array.
+		size_t head;               // Elements popped from this array index.
+		size_t tail;               // Elements pushed to this array index.
+		bool full;                 // True if queue array is full.
+
+		// Double array size, unwrapping elements to start of new array.
+		void grow()
+		{
+			std::unique_ptr<T[]> tmp = std::make_unique<T[]>(capacity * 2);
+
+			for (size_t i = 0; i < capacity; i++)
+				tmp[i] = std::move(data[(head + i) % capacity]);
+			data = std::move(tmp);
+			head = 0;
+			tail = capacity;
+			capacity *= 2;
+			full = false;
+		}
+
+	public:
+		Queue() : capacity(QUEUE_SIZE ? QUEUE_SIZE : DEFAULT_QUEUE_SIZE), head(0), tail(0), full(false) { data = std::make_unique<T[]>(capacity); }
+		~Queue() = default;
+
+		bool enqueue(T val)
+		{
+			if (full)                       // Check if queue full.
+			{
+				if (QUEUE_SIZE != GROWABLE)
+					return false;
+				grow();
+			}
+			data[tail] = val;               // Insert value into queue.
+			tail = (tail + 1) % capacity;   // Increment pointer, wrap if necessary.
+			full = (tail == head);          // Queue full?
+			return true;
+		}
+
+		bool dequeue()
+		{
+			if (empty())	                // Check if empty.
+				return false;
+			full = false;                   // Queue can not be full.
+			head = (head + 1) % capacity;   // Increment pointer (wrap if necessary).
+			return true;
+		}
+		/*
+			// Alternative version of dequeue which throws oor exception.
+			T dequeue()
+			{
+				if (empty())
+					throw std::out_of_range("empty queue");
+				T tmp = data[head];
+				full = false;                   // Queue can not be full.
+				head = (head + 1) % capacity;   // Increment pointer (wrap if necessary).
+				return tmp;
+			}
+		*/
+		bool empty() const { return (!full && (tail == head)); }
+		bool isFull() const { return full; }
+
+		T front()
+		{
+			if (empty())
+				throw std::out_of_range("empty queue");
+			else
+				return data[head];
+		}
+
+		T back()
+		{
+			if (empty())
+				throw std::out_of_range("empty queue");
+			else
+				return data[(tail ? tail - 1 : capacity - 1)];
+		}
+	};
+}
+
+#endif
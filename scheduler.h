@@ -0,0 +1,366 @@
+/*************************************************************************
+* Title: Mining Scheduler
+* File: scheduler.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Mines batches of independent chains (or forks) on a work-stealing
+* thread pool. A job mines blocks firstId to lastId - 1, the first linked
+* to previousHash, each later block to the one before it:
+*
+*   submit(job)            // returns future of mined blocks.
+*   submit(job, callback)  // calls callback(blocks) on a worker thread.
+*   submit(jobs)           // batch, returns futures in job order.
+*   wait()                 // waits for all submitted jobs.
+*
+* Blocks of a job are mined in order, but blocks of different jobs run
+* at once. Each block is mined the same as MineBlock(difficulty) from a
+* nonce of 0 (lowest winning nonce), so results match a single-threaded
+* run for any number of workers.
+*
+* Notes:
+*  (1) Each worker owns a deque of tasks. It runs its newest task, and
+*      when out of tasks, steals the oldest task of another worker.
+*  (2) A block search is split into nonce chunks (SCHEDULER_CHUNK_SIZE)
+*      claimed from a shared counter, as in the multi-threaded MineBlock.
+*      Between chunks, if workers are idle and no tasks are queued, the
+*      searching worker queues a helper task, which an idle worker steals
+*      to search the following chunks of the same block. Easy blocks
+*      finish before anyone helps, long (high difficulty) blocks spread
+*      over every otherwise idle worker, so skewed batches keep all
+*      workers busy.
+*  (3) The block search finishes when the last worker searching it leaves
+*      (every chunk below the winner has been searched). That worker
+*      queues the next block of the job on its own deque.
+*  (4) Deques are guarded by a mutex each. Only the owner and thieves use
+*      a deque, and tasks are long (a chunk or more of hashes), so the
+*      locks are rarely contended.
+*  (5) Invalid jobs (bad difficulty, empty id range) throw from submit().
+*      Callbacks must not throw.
+*  (6) A worker count of 0 uses all hardware threads.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*************************************************************************/
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include <algorithm>          // max
+#include <atomic>             // counters
+#include <climits>            // ULONG_MAX
+#include <condition_variable> // idle workers, wait
+#include <deque>              // task deques
+#include <functional>         // tasks, callbacks
+#include <future>             // results
+#include <memory>             // shared state
+#include <mutex>              // deque locks
+#include <stdexcept>          // invalid argument
+#include <string>             // hashes
+#include <thread>             // workers
+#include <utility>            // move
+#include <vector>             // workers, blocks
+
+#include "block.h"
+
+namespace myMining {
+
+	// Number of nonces a worker claims at a time.
+	constexpr unsigned long SCHEDULER_CHUNK_SIZE = 4096;
+
+	// Chain (or fork) to mine.
+	struct MiningJob
+	{
+		std::string previousHash; // Previous hash of first block.
+		unsigned int difficulty;  // Difficulty of every block.
+		unsigned long firstId;    // Ids [firstId, lastId).
+		unsigned long lastId;
+	};
+
+	struct SchedulerStats
+	{
+		unsigned long jobs;    // Jobs completed.
+		unsigned long blocks;  // Blocks mined.
+		unsigned long steals;  // Tasks taken from another worker's deque.
+		unsigned long helpers; // Helper tasks queued to split a block search.
+	};
+
+	template <class BlockType = myBlock::Block>
+	class BasicScheduler
+	{
+	public:
+		typedef std::vector<BlockType> Blocks;
+		typedef std::function<void(Blocks)> Callback;
+
+	private:
+		typedef std::function<void(unsigned int)> Task; // Called with worker index.
+
+		// Worker's tasks. Owner pushes/pops back, thieves take front.
+		struct WorkDeque
+		{
+			std::mutex lock;
+			std::deque<Task> tasks;
+		};
+
+		// Job in progress.
+		struct JobState
+		{
+			MiningJob job;
+			Blocks blocks;
+			Callback done;
+		};
+
+		// Search for nonce of one block, shared by workers mining it.
+		struct BlockSearch
+		{
+			std::shared_ptr<JobState> job;
+			const std::string previousHash;
+			BlockType block;                              // Only used by finishing worker.
+			std::atomic<unsigned long> next{ 0 };         // Next unclaimed nonce.
+			std::atomic<unsigned long> best{ ULONG_MAX }; // Lowest winning nonce.
+			std::atomic<unsigned int> active{ 0 };        // Workers searching.
+			std::atomic<unsigned int> helpers{ 0 };       // Helper tasks queued.
+			std::atomic<bool> finished{ false };
+
+			BlockSearch(std::shared_ptr<JobState> j, unsigned long id, const std::string& prev) : job(std::move(j)), previousHash(prev), block(id, prev, 0) { }
+		};
+
+		std::vector<std::unique_ptr<WorkDeque>> deques;
+		std::vector<std::thread> workers;
+		std::atomic<unsigned long> queued{ 0 };  // Tasks in all deques.
+		std::atomic<unsigned int> idle{ 0 };     // Workers waiting for tasks.
+		std::atomic<unsigned long> nextDeque{ 0 }; // Deque for next submitted job.
+		std::mutex idleLock;
+		std::condition_variable wake;            // Task queued, or stopping.
+		std::condition_variable allDone;         // No jobs outstanding.
+		unsigned long outstanding = 0;           // Jobs not yet complete (idleLock).
+		bool stopping = false;                   // (idleLock).
+
+		std::atomic<unsigned long> jobs{ 0 }, blocks{ 0 }, steals{ 0 }, helperTasks{ 0 };
+
+		void push(unsigned int worker, Task task)
+		{
+			queued++; // Before task is visible, so count never goes below 0.
+			{
+				std::lock_guard<std::mutex> guard(deques[worker]->lock);
+				deques[worker]->tasks.push_back(std::move(task));
+			}
+			if (idle.load())
+			{
+				std::lock_guard<std::mutex> guard(idleLock);
+				wake.notify_one();
+			}
+		}
+
+		// Own newest task, else oldest task of another worker.
+		bool take(unsigned int worker, Task& task)
+		{
+			const std::size_t n = deques.size();
+
+			for (std::size_t i = 0; i < n; i++)
+			{
+				WorkDeque& d = *deques[(worker + i) % n];
+				std::lock_guard<std::mutex> guard(d.lock);
+
+				if (!d.tasks.empty())
+				{
+					if (i == 0)
+					{
+						task = std::move(d.tasks.back());
+						d.tasks.pop_back();
+					}
+					else
+					{
+						task = std::move(d.tasks.front());
+						d.tasks.pop_front();
+						steals++;
+					}
+					queued--;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void run(unsigned int worker)
+		{
+			Task task;
+
+			for (;;)
+			{
+				if (take(worker, task))
+				{
+					task(worker);
+					task = nullptr;
+					continue;
+				}
+
+				std::unique_lock<std::mutex> guard(idleLock);
+				idle++;
+				wake.wait(guard, [&]() { return queued.load() || stopping; });
+				idle--;
+				if (stopping && !queued.load())
+					return;
+			}
+		}
+
+		// Start mining block id of job.
+		void startBlock(unsigned int worker, std::shared_ptr<JobState> job, unsigned long id)
+		{
+			const std::string previousHash = id == job->job.firstId ? job->job.previousHash : job->blocks.back().getHash();
+			auto search = std::make_shared<BlockSearch>(std::move(job), id, previousHash);
+
+			searchBlock(worker, search);
+		}
+
+		// Search chunks of block until winner found, helped by idle workers.
+		void searchBlock(unsigned int worker, const std::shared_ptr<BlockSearch>& s)
+		{
+			const unsigned int difficulty = s->job->job.difficulty;
+			unsigned long found;
+
+			s->active++;
+			for (;;)
+			{
+				unsigned long base = s->next.fetch_add(SCHEDULER_CHUNK_SIZE);
+
+				if (base > s->best.load())
+					break;
+
+				if (BlockType::findNonceIn(s->previousHash, base, SCHEDULER_CHUNK_SIZE, difficulty, found))
+				{
+					// Keep the lowest winner.
+					unsigned long current = s->best.load();
+					while (found < current && !s->best.compare_exchange_weak(current, found))
+						;
+					break;
+				}
+
+				// Split search if workers have nothing to do.
+				if (idle.load() && !queued.load() && s->helpers.load() + 1 < workers.size())
+				{
+					s->helpers++;
+					helperTasks++;
+					push(worker, [this, s](unsigned int w) { searchBlock(w, s); });
+				}
+			}
+
+			// Last worker out finishes block, every chunk below the winner is searched.
+			if (--s->active == 0 && !s->finished.exchange(true))
+				finishBlock(worker, s);
+		}
+
+		void finishBlock(unsigned int worker, const std::shared_ptr<BlockSearch>& s)
+		{
+			std::shared_ptr<JobState> job = s->job;
+			BlockType& b = s->block;
+
+			b.setNonce(s->best.load());
+			b.setHash(digestString(BlockType::calcHash(s->previousHash, b.getNonce())));
+			job->blocks.push_back(std::move(b));
+			blocks++;
+
+			unsigned long id = job->blocks.back().getID() + 1;
+			if (id < job->job.lastId)
+			{
+				// Next block on own deque, it most likely runs next on this worker.
+				push(worker, [this, job, id](unsigned int w) { startBlock(w, job, id); });
+				return;
+			}
+
+			job->done(std::move(job->blocks));
+			jobs++;
+
+			std::lock_guard<std::mutex> guard(idleLock);
+			if (--outstanding == 0)
+				allDone.notify_all();
+		}
+
+	public:
+		// Start pool (worker count, 0 = all hardware threads).
+		explicit BasicScheduler(unsigned int threads = 0)
+		{
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			for (unsigned int i = 0; i < threads; i++)
+				deques.push_back(std::make_unique<WorkDeque>());
+			for (unsigned int i = 0; i < threads; i++)
+				workers.emplace_back(&BasicScheduler::run, this, i);
+		}
+
+		// Waits for submitted jobs, then stops pool.
+		~BasicScheduler()
+		{
+			wait();
+			{
+				std::lock_guard<std::mutex> guard(idleLock);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (auto& t : workers)
+				t.join();
+		}
+
+		BasicScheduler(const BasicScheduler&) = delete;
+		BasicScheduler& operator= (const BasicScheduler&) = delete;
+
+		// Mine job, callback(blocks) is called on a worker thread.
+		void submit(const MiningJob& job, Callback callback)
+		{
+			if (job.lastId <= job.firstId)
+				throw std::invalid_argument("empty block id range");
+			// Throws for invalid difficulty here, rather than inside a worker.
+			BlockType::meetsDifficulty(typename BlockType::digest_type(), job.difficulty);
+
+			auto state = std::make_shared<JobState>();
+			state->job = job;
+			state->blocks.reserve(job.lastId - job.firstId);
+			state->done = std::move(callback);
+			{
+				std::lock_guard<std::mutex> guard(idleLock);
+				outstanding++;
+			}
+
+			// Spread jobs over deques, workers steal to balance.
+			unsigned int worker = static_cast<unsigned int>(nextDeque++ % deques.size());
+			push(worker, [this, state](unsigned int w) { startBlock(w, state, state->job.firstId); });
+		}
+
+		// Mine job, returns future of blocks.
+		std::future<Blocks> submit(const MiningJob& job)
+		{
+			auto promise = std::make_shared<std::promise<Blocks>>();
+			std::future<Blocks> result = promise->get_future();
+
+			submit(job, [promise](Blocks b) { promise->set_value(std::move(b)); });
+			return result;
+		}
+
+		// Mine batch of jobs, returns futures in job order.
+		std::vector<std::future<Blocks>> submit(const std::vector<MiningJob>& batch)
+		{
+			std::vector<std::future<Blocks>> results;
+
+			results.reserve(batch.size());
+			for (const MiningJob& job : batch)
+				results.push_back(submit(job));
+			return results;
+		}
+
+		// Wait until all submitted jobs are complete.
+		void wait()
+		{
+			std::unique_lock<std::mutex> guard(idleLock);
+			allDone.wait(guard, [&]() { return outstanding == 0; });
+		}
+
+		unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+		SchedulerStats stats() const { return SchedulerStats{ jobs.load(), blocks.load(), steals.load(), helperTasks.load() }; }
+	};
+
+	typedef BasicScheduler<> Scheduler;
+}
+
+#endif
@@ -0,0 +1,257 @@
+/*************************************************************************
+* Title: Statistics
+* File: stats.h
+* Author: James Eli
+* Date: 10/17/2026
+*
+* Mining and tree instrumentation, compiled in when MINING_STATS is
+* defined. Records, for each mined block, the attempts (nonces from start
+* to winner), wall time, hash rate and winning nonce, and passes them to a
+* pluggable sink. Also counts hashes computed and tree find/insert probe
+* depths in per thread counters, which are summed on demand:
+*
+*   setSink(sink)      // block and tree records go to sink (nullptr = none).
+*   totals()           // sum of all threads' counters.
+*   reset()            // zero all counters.
+*   reportTree(tree)   // send tree size, height and probe depths to sink.
+*
+* Instrumented code uses STATS_COUNT(counter, n), and STATS_BLOCK_START(first
+* nonce)/STATS_BLOCK_END(id, nonce, threads) around mining. Without
+* MINING_STATS these expand to nothing.
+*
+* Notes:
+*  (1) Define MINING_STATS for every file (ex. -DMINING_STATS), since
+*      tree.h and block.cpp are both instrumented.
+*  (2) A thread only ever writes its own counters (relaxed atomic stores,
+*      no read-modify-write), so counting doesn't contend between threads.
+*      Counters of exited threads are added to a retired total.
+*  (3) StreamSink writes one line per record to any stream, leaving the
+*      stream's format flags and precision as it found them.
+*
+*************************************************************************
+* Change Log:
+*   10/17/2026: Initial release. JME
+*   10/17/2026: StreamSink restores stream format. JME
+*************************************************************************/
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <algorithm> // remove
+#include <atomic>    // counters, sink
+#include <chrono>    // block timing
+#include <cstdint>   // uint64_t
+#include <iomanip>   // manipulators
+#include <mutex>     // counter registry
+#include <ostream>   // stream sink
+#include <vector>    // live thread counters
+
+namespace myStats {
+
+	// Counted events.
+	enum Counter { HASHES, TREE_FINDS, TREE_FIND_PROBES, TREE_INSERTS, TREE_INSERT_PROBES, COUNTERS };
+
+	inline const char* counterName(Counter c)
+	{
+		static const char* names[COUNTERS] = { "hashes", "tree finds", "tree find probes", "tree inserts", "tree insert probes" };
+		return names[c];
+	}
+
+	// Summed counters.
+	struct Totals
+	{
+		uint64_t value[COUNTERS] = {};
+
+		uint64_t operator[] (Counter c) const { return value[c]; }
+	};
+
+	// Mined block record.
+	struct BlockStats
+	{
+		unsigned long id;       // Block id.
+		unsigned long nonce;    // Winning nonce.
+		uint64_t attempts;      // Nonces from start to winner (inclusive).
+		double seconds;         // Wall time.
+		double hashRate;        // Attempts per second.
+		unsigned int threads;   // Mining threads (0 = all hardware threads).
+	};
+
+	// Tree record.
+	struct TreeStats
+	{
+		std::size_t size;       // Node count.
+		int height;             // Tree height.
+		double findDepth;       // Average nodes visited per find.
+		double insertDepth;     // Average nodes visited per insert.
+	};
+
+	// Receives records.
+	class StatsSink
+	{
+	public:
+		virtual ~StatsSink() = default;
+		virtual void block(const BlockStats&) = 0;
+		virtual void tree(const TreeStats&) = 0;
+	};
+
+	// Writes records as text lines.
+	class StreamSink : public StatsSink
+	{
+		std::ostream& os;
+
+		// Restores stream flags and precision on scope exit.
+		class FormatGuard
+		{
+			std::ostream& os;
+			std::ios_base::fmtflags flags;
+			std::streamsize precision;
+
+		public:
+			explicit FormatGuard(std::ostream& s) : os(s), flags(s.flags()), precision(s.precision()) { }
+			~FormatGuard() { os.flags(flags); os.precision(precision); }
+		};
+
+	public:
+		explicit StreamSink(std::ostream& s) : os(s) { }
+
+		void block(const BlockStats& b) override
+		{
+			FormatGuard guard(os);
+			os << "block " << std::setw(4) << b.id << " nonce " << std::setw(10) << b.nonce << " attempts " << std::setw(10) << b.attempts
+				<< " time " << std::fixed << std::setprecision(6) << b.seconds << " s " << std::setprecision(0) << b.hashRate << " hashes/s\n";
+		}
+
+		void tree(const TreeStats& t) override
+		{
+			FormatGuard guard(os);
+			os << "tree size " << t.size << " height " << t.height << std::fixed << std::setprecision(2)
+				<< " find depth " << t.findDepth << " insert depth " << t.insertDepth << "\n";
+		}
+	};
+
+	// One thread's counters.
+	class ThreadCounters;
+
+	struct Registry
+	{
+		std::mutex lock;
+		std::vector<const ThreadCounters*> live; // Counters of running threads.
+		Totals retired;                          // Sum of exited threads' counters.
+	};
+
+	inline Registry& registry()
+	{
+		static Registry r;
+		return r;
+	}
+
+	class ThreadCounters
+	{
+		std::atomic<uint64_t> value[COUNTERS];
+
+	public:
+		ThreadCounters()
+		{
+			for (auto& v : value)
+				v.store(0, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> guard(registry().lock);
+			registry().live.push_back(this);
+		}
+		~ThreadCounters()
+		{
+			Registry& r = registry();
+			std::lock_guard<std::mutex> guard(r.lock);
+
+			addTo(r.retired);
+			r.live.erase(std::remove(r.live.begin(), r.live.end(), this), r.live.end());
+		}
+
+		ThreadCounters(const ThreadCounters&) = delete;
+		ThreadCounters& operator= (const ThreadCounters&) = delete;
+
+		// Only called by owning thread.
+		void add(Counter c, uint64_t n) { value[c].store(value[c].load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+		void addTo(Totals& t) const
+		{
+			for (int c = 0; c < COUNTERS; c++)
+				t.value[c] += value[c].load(std::memory_order_relaxed);
+		}
+
+		void reset()
+		{
+			for (auto& v : value)
+				v.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	inline thread_local ThreadCounters threadCounters;
+	inline std::atomic<StatsSink*> currentSink{ nullptr };
+
+	inline void count(Counter c, uint64_t n) { threadCounters.add(c, n); }
+
+	// Sum of all threads' counters.
+	inline Totals totals()
+	{
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+		Totals t = r.retired;
+
+		for (auto tc : r.live)
+			tc->addTo(t);
+		return t;
+	}
+
+	// Zero all counters (racy while other threads are counting).
+	inline void reset()
+	{
+		Registry& r = registry();
+		std::lock_guard<std::mutex> guard(r.lock);
+
+		r.retired = Totals();
+		for (auto tc : r.live)
+			const_cast<ThreadCounters*>(tc)->reset();
+	}
+
+	inline void setSink(StatsSink* sink) { currentSink.store(sink); }
+	inline StatsSink* sink() { return currentSink.load(); }
+
+	// Send block record to sink (id, first nonce, winning nonce, threads, start time).
+	inline void recordBlock(unsigned long id, unsigned long first, unsigned long nonce, unsigned int threads,
+		std::chrono::steady_clock::time_point start)
+	{
+		if (StatsSink* s = sink())
+		{
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			uint64_t attempts = nonce - first + 1;
+
+			s->block(BlockStats{ id, nonce, attempts, elapsed.count(), elapsed.count() > 0 ? attempts / elapsed.count() : 0, threads });
+		}
+	}
+
+	// Send tree record to sink. Probe depths average over all trees counted.
+	template <class TreeType>
+	void reportTree(const TreeType& t)
+	{
+		if (StatsSink* s = sink())
+		{
+			Totals c = totals();
+
+			s->tree(TreeStats{ t.size(), t.getHeight(),
+				c[TREE_FINDS] ? static_cast<double>(c[TREE_FIND_PROBES]) / c[TREE_FINDS] : 0,
+				c[TREE_INSERTS] ? static_cast<double>(c[TREE_INSERT_PROBES]) / c[TREE_INSERTS] : 0 });
+		}
+	}
+}
+
+#ifdef MINING_STATS
+#define STATS_COUNT(counter, n) myStats::count(myStats::counter, (n))
+#define STATS_BLOCK_START(first) const unsigned long statsFirst = (first); const auto statsStart = std::chrono::steady_clock::now()
+#define STATS_BLOCK_END(id, nonce, threads) myStats::recordBlock((id), statsFirst, (nonce), (threads), statsStart)
+#else
+#define STATS_COUNT(counter, n) ((void)0)
+#define STATS_BLOCK_START(first) ((void)0)
+#define STATS_BLOCK_END(id, nonce, threads) ((void)0)
+#endif
+
+#endif
@@ -1,304 +1,665 @@
-/*************************************************************************
-* Title: Binary Search Tree
-* File: tree.h
-* Author: James Eli
-* Date: 10/26/2018
-*
-* Basic tree data structure using smart pointers. Basic tree functionality
-* needed for assignment is included:
-*
-*   clear()      // deletes tree.
-*   empty()      // returns true if tree is empty.
-*   size()       // returns tree size (number of nodes).
-*   add(T)       // recursive insert new node. does NOT check if T 
-*                // already exists.
-*   find(T)      // recursively find first occurrence of data in tree.
-*                // returns true if T is found.
-*   inOrder()    // dfs inorder recursive traversal.
-*   bfs()        // bfs non-recursive traversal (top down, left to right).
-*
-* Bonus functions compiled if BALANCE_TREE is defined:
-*   remove(T)    // Remove first occurrence of data.
-*   getHeight()  // returns height of tree.
-*   isBalanced() // returns true if tree is balanced.
-*   balance()    // attempts to balance tree.
-*
-* Notes:
-*  (1) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
-*  (2) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*  10/26/2018: Initial release. JME
-*************************************************************************/
-#ifndef _MY_TREE_H_
-#define _MY_TREE_H_
-
-#include <iostream>  // cout.
-#include <memory>    // shared pointers.
-#include <algorithm> // max.
-// Using my data structures.
-#include "queue.h"   // bfs traversal.
-#include "vector.h"  // vector for building balanced tree.
-
-using namespace myQueue;
-using namespace myVector;
-
-namespace myTree {
-
-	template <class T>
-	class Tree
-	{
-	private:
-		struct Node
-		{
-		private:
-			T data;                      // Node data element.
-			std::shared_ptr<Node> left;  // Left child.
-			std::shared_ptr<Node> right; // Right child.
-
-			// Return true if node is leaf.
-			bool isLeaf() const { return !left && !right; }
-		
-		public:
-			explicit Node(T d) : data(d), left(nullptr), right(nullptr) { }
-			~Node() = default;
-		
-			friend class Tree;
-		};
-
-		// Tree root node.
-		std::shared_ptr<Node> root;
-	
-	public:
-		Tree() : root(nullptr) { }
-
-		~Tree() = default;
-	
-		// Clear all nodes from tree.
-		void clear() { clear(root); }
-		
-		// Return true if tree is empty.
-		bool empty() const { return (root == nullptr); }
-		
-		// Return node count.
-		std::size_t size() { return size(root); }
-		
-		// Insert item into tree.
-		void add(T data) { add(root, data); }
-		
-		// recursive search.
-		bool find(T data) const { return find(root, data); }
-		
-		// Dfs in-order traversal (recursive).
-		void inOrder() const { inOrder(root); }
-		
-		// Bfs traversal (top down, left to right).
-		void bfs() const { bfs(root); }
-
-#ifdef BALANCE_TREE
-		// Remove first occurrence of data.
-		bool remove(T data) { return remove(root, data); }
-
-		// Get height of node. Used by isBalanced function.
-		int getHeight() { return getHeight(root); }
-		
-		// Recursive check of tree balance. Returns true if tree is balanced.
-		bool isBalanced() { return isBalanced(root); }
-		
-		// Attempt to balance tree.
-		void balance() { balanceTree(root); }
-#endif // End BALANCE_TREE.
-
-	private:
-		// Delete all nodes of tree.
-		void clear(std::shared_ptr<Node> &node)
-		{
-			if (node->left)
-				clear(node->left);
-			if (node->right)
-				clear(node->right);
-			node.reset(); 
-		}
-
-		// Number of nodes in tree.
-		std::size_t size(std::shared_ptr<Node> &node)
-		{
-			if (!node)
-				return 0;
-			else
-				return(size(node->left) + 1 + size(node->right));
-		}
-
-		// Add new node to tree.
-		void add(std::shared_ptr<Node> &node, T &data)
-		{
-			if (!node)
-				node = std::make_shared<Node>(data);
-			else
-				data < node->data ? add(node->left, data) : add(node->right, data);
-		}
-
-		// Recursively find first occurrence of data in tree.
-		bool find(std::shared_ptr<Node> node, T &data) const
-		{
-			if (!node)
-				return false;
-			else
-			{
-				if (node->data == data)
-					return true;
-
-				return find(node->left, data) || find(node->right, data);
-			}
-		}
-		
-		// Dfs in-order traversal.
-		void inOrder(const std::shared_ptr<Node> node) const
-		{
-			if (node->left)
-				inOrder(node->left);
-			std::cout << node->data;
-			if (node->right)
-				inOrder(node->right);
-		}
-
-		// Bfs traversal (top down, left to right).
-		void bfs(std::shared_ptr<Node> node) const
-		{
-			Queue<std::shared_ptr<Node>> q;
-
-			if (node != nullptr)
-			{
-				q.enqueue(node);
-
-				while (!q.empty())
-				{
-					node = q.front();
-					q.dequeue();
-
-					std::cout << node->data;
-
-					if (node->left != nullptr)
-						q.enqueue(node->left);
-
-					if (node->right != nullptr)
-						q.enqueue(node->right);
-				}
-			}
-		}
-
-#ifdef BALANCE_TREE
-		// Return minimum value of either child nodes.
-		T min(std::shared_ptr<Node> node) const
-		{
-			if (node->isLeaf())
-				return node->data;
-
-			return node->left ? min(node->left) : min(node->right);
-		}
-
-		// Remove first instance of data from tree.
-		bool remove(std::shared_ptr<Node>& node, T data)
-		{
-			if (!node)
-				return false;
-			else
-			{
-				if (node->data == data)
-				{
-					// No children.
-					if (node->isLeaf())
-						node.reset();
-					else
-					{
-						// Node has 2 children.
-						if (node->left && node->right)
-						{
-							T dataReplace = min(node->right);
-
-							remove(dataReplace);
-							node->data = dataReplace;
-						}
-						else
-						{
-							// Node has 1 child.
-							std::shared_ptr<Node> tempPtr;
-
-							node->left ? tempPtr = node->left : tempPtr = node->right;
-							node.reset();   // Decrement use count.
-							node = tempPtr; // Replace with only child.
-						}
-					}
-
-					return true;
-				}
-
-				return remove(node->left, data) || remove(node->right, data);
-			}
-		}
-
-		// Get height of node. Used by isBalanced function.
-		static int getHeight(std::shared_ptr<Node> node)
-		{
-			return node == nullptr ? 0 : std::max(getHeight(node->left), getHeight(node->right)) + 1;
-		}
-
-		// Check if tree is balanced.
-		static bool isBalanced(std::shared_ptr<Node> node)
-		{
-			if (node == nullptr)
-				return true;
-
-			int left = getHeight(node->left);
-			int right = getHeight(node->right);
-
-			return (abs(left - right) <= 1 && isBalanced(node->left) && isBalanced(node->right));
-		}
-
-		// Balance tree helper method, builds tree from (sorted) array of data elements.
-		void buildTree(Vector<T>& data, int start, int end)
-		{
-			if (start <= end)
-			{
-				int mid = (start + end) / 2;
-
-				add(data[mid]);
-
-				buildTree(data, start, mid - 1);
-				buildTree(data, mid + 1, end);
-			}
-		}
-
-		// Balance tree helper method, constructs sorted array of tree data via inOrder traversal.
-		void makeArray(std::shared_ptr<Node> node, Vector<T>& data)
-		{
-			// Base case.
-			if (!node)
-				return;
-
-			// Store tree nodes inorder.
-			makeArray(node->left, data);
-			data.push_back(node->data);
-			makeArray(node->right, data);
-		}
-
-		// Attempt to reconstruct tree as balanced. 
-		void balanceTree(std::shared_ptr<Node> node)
-		{
-			// Store nodes in sorted order.
-			Vector<T> data;
-			makeArray(node, data);
-			// Reconstruct a balanced tree.
-			clear(root);
-			// Static cast required for x64 because size_t == 64-bits.
-			buildTree(data, 0, static_cast<int>(data.size() - 1));
-		}
-#endif // End BALANCE_TREE.
-	};
-}
-
-#endif
+/*************************************************************************
+* Title: Binary Search Tree
+* File: tree.h
+* Author: James Eli
+* Date: 10/26/2018
+*
+* Basic tree data structure with nodes allocated from a pool (contiguous
+* slabs) and linked by raw pointers. Basic tree functionality needed for
+* assignment is included:
+*
+*   clear()      // deletes tree (resets node pool).
+*   empty()      // returns true if tree is empty.
+*   size()       // returns tree size (number of nodes).
+*   add(T)       // insert new node. does NOT check if T already exists.
+*   find(T)      // find first occurrence of data in tree (ordered
+*                // descent). returns true if T is found.
+*   insertUnique(T) // insert new node only if T doesn't already exist.
+*                // returns true if inserted.
+*   inOrder()    // dfs inorder traversal, prints elements.
+*   bfs()        // bfs traversal (top down, left to right), prints elements.
+*   inOrder(visit) // calls visit(element) for each element, in order.
+*   bfs(visit)   // calls visit(element) for each element, bfs order.
+*   begin(), end() // in-order (sorted) iterators.
+*   remove(T)    // Remove first occurrence of data.
+*   getHeight()  // returns height of tree (cached, O(1)).
+*   isBalanced() // returns true if tree is balanced.
+*   freeze(keyOf) // read-only Eytzinger ordered snapshot (frozen_tree.h).
+*   bulkLoad(first, last, unique) // insert range, rebuilds balanced tree.
+*   merge(tree, unique) // insert items of another tree, rebuilds balanced
+*                // tree. Both return number of items inserted.
+*
+* Bonus function compiled if BALANCE_TREE is defined:
+*   balance()    // attempts to balance tree (rebuild).
+*
+* Balance policy (second template parameter):
+*   Unbalanced   // plain binary search tree (default).
+*   AVL          // self-balancing, rotates on each add/remove so subtree
+*                // heights never differ by more than 1.
+*
+* Notes:
+*  (1) Nodes are owned by the tree's pool, not by their parent. Removing a
+*      node returns it to the pool, clear() resets the pool without
+*      walking the tree.
+*  (2) Trees can be moved but not copied.
+*  (3) Every node caches its height, updated along the insert/remove path.
+*      Inserts, removes and traversals are iterative, so a degenerate
+*      (unbalanced) tree doesn't overflow the stack.
+*  (4) bulkLoad() sorts the range unless already sorted (parallelStableSort,
+*      split across threads from PARALLEL_SORT_SIZE items), then merges it
+*      with the in-order nodes of the tree and links the result into a
+*      perfectly balanced tree, in linear time with no rotations. Existing nodes are relinked, not
+*      copied. Equal items end up in the same order as with add() (tree
+*      items, then range items in range order), and with unique set the
+*      first of equal items is kept, as with insertUnique().
+*  (5) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
+*  (6) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*  10/26/2018: Initial release. JME
+*  10/16/2026: Replaced shared pointer nodes with pool allocated nodes. JME
+*  10/16/2026: find() descends by order instead of searching whole tree.
+*              Added insertUnique(). JME
+*  10/16/2026: Added balance policy (AVL), cached node heights. remove(),
+*              getHeight() and isBalanced() no longer need BALANCE_TREE. JME
+*  10/16/2026: Added freeze(). JME
+*  10/17/2026: bfs() uses a growable queue, no longer drops nodes. JME
+*  10/17/2026: balance() relinks nodes instead of copying data. Nodes are
+*              moved into pool. JME
+*  10/17/2026: Traversals are iterative, added visitor traversals and 
+*              iterators. JME
+*  10/17/2026: find() and insert() count probe depth (see stats.h). JME
+*  10/17/2026: Added bulkLoad() and merge(). buildTree() and makeArray()
+*              no longer need BALANCE_TREE. JME
+*  10/17/2026: Move assignment ignores self-move. JME
+*  10/17/2026: Bulk load sort is parallelStableSort(), thread count can be
+*              given. JME
+*************************************************************************/
+#ifndef _MY_TREE_H_
+#define _MY_TREE_H_
+
+#include <iostream>  // cout.
+#include <algorithm> // max.
+#include <cstddef>   // ptrdiff_t.
+#include <cstdlib>   // abs.
+#include <iterator>  // iterator tags.
+#include <thread>    // parallel sort.
+#include <type_traits> // decay.
+#include <vector>    // frozen tree arrays.
+#include "stats.h"   // probe counters.
+// Using my data structures.
+#include "frozen_tree.h" // read-only snapshot.
+#include "pool.h"    // node pool.
+#include "queue.h"   // bfs traversal.
+#include "vector.h"  // vector for building balanced tree.
+
+using namespace myPool;
+using namespace myQueue;
+using namespace myVector;
+
+namespace myTree {
+
+	// Bulk loaded ranges of at least this many items are sorted by several threads.
+	constexpr std::size_t PARALLEL_SORT_SIZE = 1 << 16;
+
+	// Stable sort, split across threads (0 = all hardware threads) when there
+	// are at least PARALLEL_SORT_SIZE items. Threads sort equal runs, then
+	// neighbouring runs are merged (in parallel) until one run is left.
+	template <class T>
+	void parallelStableSort(std::vector<T>& items, std::size_t threads = 0)
+	{
+		const std::size_t n = items.size();
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		if (n < PARALLEL_SORT_SIZE || threads == 1)
+		{
+			std::stable_sort(items.begin(), items.end());
+			return;
+		}
+
+		const std::size_t run = (n + threads - 1) / threads;
+		std::vector<std::thread> workers;
+
+		for (std::size_t start = 0; start < n; start += run)
+			workers.emplace_back([&items, start, run, n]() { std::stable_sort(items.begin() + start, items.begin() + std::min(start + run, n)); });
+		for (auto& t : workers)
+			t.join();
+
+		for (std::size_t width = run; width < n; width *= 2)
+		{
+			workers.clear();
+			for (std::size_t start = 0; start + width < n; start += 2 * width)
+				workers.emplace_back([&items, start, width, n]() 
+				{ 
+					std::inplace_merge(items.begin() + start, items.begin() + start + width, items.begin() + std::min(start + 2 * width, n)); 
+				});
+			for (auto& t : workers)
+				t.join();
+		}
+	}
+
+	// Plain binary search tree, node heights are maintained but never rebalanced.
+	struct Unbalanced
+	{
+		static constexpr bool selfBalancing = false;
+
+		template <class Node>
+		static void rebalance(Node *&node) { node->updateHeight(); }
+	};
+
+	// AVL tree, rotates so that the heights of a node's subtrees differ by at 
+	// most 1. Called for each node on the insert/remove path, bottom up.
+	struct AVL
+	{
+		static constexpr bool selfBalancing = true;
+
+		template <class Node>
+		static void rebalance(Node *&node)
+		{
+			int balance = Node::height(node->left) - Node::height(node->right);
+
+			if (balance > 1)
+			{
+				// Left-right case.
+				if (Node::height(node->left->left) < Node::height(node->left->right))
+					rotateLeft(node->left);
+				rotateRight(node);
+			}
+			else if (balance < -1)
+			{
+				// Right-left case.
+				if (Node::height(node->right->right) < Node::height(node->right->left))
+					rotateRight(node->right);
+				rotateLeft(node);
+			}
+			else
+				node->updateHeight();
+		}
+
+	private:
+		template <class Node>
+		static void rotateLeft(Node *&node)
+		{
+			Node *right = node->right;
+
+			node->right = right->left;
+			right->left = node;
+			node->updateHeight();
+			right->updateHeight();
+			node = right;
+		}
+
+		template <class Node>
+		static void rotateRight(Node *&node)
+		{
+			Node *left = node->left;
+
+			node->left = left->right;
+			left->right = node;
+			node->updateHeight();
+			left->updateHeight();
+			node = left;
+		}
+	};
+
+	template <class T, class Balance = Unbalanced>
+	class Tree
+	{
+	private:
+		struct Node
+		{
+		private:
+			T data;      // Node data element.
+			Node *left;  // Left child.
+			Node *right; // Right child.
+			int level;   // Height of subtree rooted here (leaf = 1).
+
+			// Return true if node is leaf.
+			bool isLeaf() const { return !left && !right; }
+		
+		public:
+			explicit Node(const T& d) : data(d), left(nullptr), right(nullptr), level(1) { }
+
+			// Height of subtree (0 if empty).
+			static int height(const Node *node) { return node ? node->level : 0; }
+			// Recalculate height from children.
+			void updateHeight() { level = std::max(height(left), height(right)) + 1; }
+		
+			friend class Tree;
+			friend Balance;
+		};
+
+		// Node storage.
+		Pool<Node> pool;
+		// Tree root node.
+		Node *root;
+		// Links from root to current node, used to retrace insert/remove path.
+		Vector<Node**> path;
+	
+	public:
+		Tree() : root(nullptr) { }
+		Tree(Tree&& rhs) : pool(std::move(rhs.pool)), root(rhs.root) { rhs.root = nullptr; }
+
+		~Tree() = default;
+
+		Tree& operator= (Tree&& rhs)
+		{
+			if (this != &rhs)
+			{
+				pool = std::move(rhs.pool);
+				root = rhs.root;
+				rhs.root = nullptr;
+			}
+			return *this;
+		}
+	
+		// Clear all nodes from tree.
+		void clear() { pool.reset(); root = nullptr; }
+		
+		// Return true if tree is empty.
+		bool empty() const { return (root == nullptr); }
+		
+		// Return node count.
+		std::size_t size() const { return pool.size(); }
+		
+		// Insert item into tree.
+		void add(const T& data) { insert(data, false); }
+		
+		// Ordered search.
+		bool find(const T& data) const { return find(root, data); }
+
+		// Insert item into tree if not already present (single descent).
+		bool insertUnique(const T& data) { return insert(data, true); }
+		
+		// Dfs in-order traversal, prints elements.
+		void inOrder() const { inOrder([](const T& data) { std::cout << data; }); }
+		
+		// Bfs traversal (top down, left to right), prints elements.
+		void bfs() const { bfs([](const T& data) { std::cout << data; }); }
+
+		// Dfs in-order traversal, calls visit(data) for each node. Iterative, 
+		// so safe for trees of any height.
+		template <class Visit>
+		void inOrder(Visit visit) const
+		{
+			Vector<const Node*> stack;
+			const Node *node = root;
+
+			stack.reserve(getHeight());
+			while (node || stack.size())
+			{
+				while (node)
+				{
+					stack.push_back(node);
+					node = node->left;
+				}
+
+				node = stack.back();
+				stack.pop_back();
+				visit(node->data);
+				node = node->right;
+			}
+		}
+
+		// Bfs traversal (top down, left to right), calls visit(data) for each node.
+		template <class Visit>
+		void bfs(Visit visit) const
+		{
+			// Growable, a wide tree holds more than DEFAULT_QUEUE_SIZE nodes per level.
+			Queue<const Node*, GROWABLE> q;
+
+			if (root != nullptr)
+			{
+				q.enqueue(root);
+
+				while (!q.empty())
+				{
+					const Node *node = q.front();
+					q.dequeue();
+
+					visit(node->data);
+
+					if (node->left != nullptr)
+						q.enqueue(node->left);
+
+					if (node->right != nullptr)
+						q.enqueue(node->right);
+				}
+			}
+		}
+
+		// In-order iterator. Holds the path of nodes whose right subtree is
+		// still to be visited, the current node on top.
+		class const_iterator
+		{
+		private:
+			Vector<const Node*> stack;
+
+			void pushLeft(const Node *node)
+			{
+				while (node)
+				{
+					stack.push_back(node);
+					node = node->left;
+				}
+			}
+
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef T value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const T* pointer;
+			typedef const T& reference;
+
+			const_iterator() = default;
+			const_iterator(const Node *root, int height)
+			{
+				stack.reserve(height);
+				pushLeft(root);
+			}
+
+			reference operator*() const { return stack.back()->data; }
+			pointer operator->() const { return &stack.back()->data; }
+
+			const_iterator& operator++()
+			{
+				const Node *node = stack.back();
+				stack.pop_back();
+				pushLeft(node->right);
+				return *this;
+			}
+			const_iterator operator++(int)
+			{
+				const_iterator tmp(*this);
+				++*this;
+				return tmp;
+			}
+
+			bool operator== (const const_iterator& rhs) const
+			{
+				if (stack.empty() || rhs.stack.empty())
+					return stack.empty() && rhs.stack.empty();
+				return stack.back() == rhs.stack.back();
+			}
+			bool operator!= (const const_iterator& rhs) const { return !(*this == rhs); }
+		};
+		// Elements can't be modified in place, that could break the tree order.
+		typedef const_iterator iterator;
+
+		const_iterator begin() const { return const_iterator(root, getHeight()); }
+		const_iterator end() const { return const_iterator(); }
+
+		// Remove first occurrence of data.
+		bool remove(const T& data) { return remove(root, data); }
+
+		// Get height of tree.
+		int getHeight() const { return Node::height(root); }
+		
+		// Check of tree balance. Returns true if tree is balanced.
+		bool isBalanced() const { return Balance::selfBalancing || isBalanced(root); }
+
+		// Read-only snapshot of tree. keyOf returns the key the tree is ordered 
+		// by (ex. nonce of a block). Without keyOf, the data is its own key.
+		template <class KeyOf, class Key = std::decay_t<decltype(std::declval<KeyOf>()(std::declval<const T&>()))>>
+		FrozenTree<T, Key> freeze(KeyOf keyOf) const
+		{
+			std::vector<T> sorted;
+			std::vector<Key> keys;
+
+			sorted.reserve(size());
+			keys.reserve(size());
+			inOrder([&](const T& data) 
+			{ 
+				sorted.push_back(data); 
+				keys.push_back(keyOf(data)); 
+			});
+
+			return FrozenTree<T, Key>(sorted, keys);
+		}
+		FrozenTree<T, T> freeze() const { return freeze([](const T& data) { return data; }); }
+
+		// Insert range of items, rebuilding a balanced tree. With unique, items
+		// already in tree (or earlier in range) are skipped.
+		template <class InputIt>
+		std::size_t bulkLoad(InputIt first, InputIt last, bool unique = false)
+		{
+			// Sorted (multi-pass) range is merged in place.
+			if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>::value)
+				if (std::is_sorted(first, last))
+					return mergeSorted(first, static_cast<std::size_t>(std::distance(first, last)), unique);
+
+			std::vector<T> items(first, last);
+
+			parallelStableSort(items);
+			return mergeSorted(items.begin(), items.size(), unique);
+		}
+
+		// Insert copies of other tree's items (already in order), rebuilding a
+		// balanced tree. With unique, items already in tree are skipped.
+		std::size_t merge(const Tree& other, bool unique = false)
+		{
+			if (&other == this)
+			{
+				std::vector<T> items(begin(), end());
+				return mergeSorted(items.begin(), items.size(), unique);
+			}
+			return mergeSorted(other.begin(), other.size(), unique);
+		}
+
+#ifdef BALANCE_TREE
+		// Attempt to balance tree.
+		void balance() { balanceTree(root); }
+#endif // End BALANCE_TREE.
+
+	private:
+		// Add new node to tree, unless unique and data already exists. Equal
+		// data is added to the right.
+		bool insert(const T &data, bool unique)
+		{
+			Node **link = &root;
+
+			path.clear();
+			while (*link)
+			{
+				path.push_back(link);
+				if (data < (*link)->data)
+					link = &(*link)->left;
+				else if (unique && (*link)->data == data)
+					break;
+				else
+					link = &(*link)->right;
+			}
+			STATS_COUNT(TREE_INSERTS, 1);
+			STATS_COUNT(TREE_INSERT_PROBES, path.size());
+			if (*link)
+				return false;
+
+			*link = pool.allocate(Node(data));
+			retrace();
+			return true;
+		}
+
+		// Update heights (and rebalance) bottom up along path.
+		void retrace()
+		{
+			while (path.size())
+			{
+				Balance::rebalance(*path[path.size() - 1]);
+				path.pop_back();
+			}
+		}
+
+		// Find first occurrence of data in tree. Equal data is added to the
+		// right, and rotations keep in-order sequence, so an occurrence is 
+		// always on the search path.
+		bool find(const Node *node, const T &data) const
+		{
+			STATS_COUNT(TREE_FINDS, 1);
+			while (node)
+			{
+				STATS_COUNT(TREE_FIND_PROBES, 1);
+				if (data < node->data)
+					node = node->left;
+				else if (node->data == data)
+					return true;
+				else
+					node = node->right;
+			}
+
+			return false;
+		}
+
+		// Remove first occurrence of data from tree (same search as find). A
+		// node with 2 children takes the data of its in-order successor, and 
+		// the successor node is removed instead.
+		bool remove(Node *&node, const T &data)
+		{
+			Node **link = &node;
+
+			path.clear();
+			while (*link && !((*link)->data == data))
+			{
+				path.push_back(link);
+				link = data < (*link)->data ? &(*link)->left : &(*link)->right;
+			}
+
+			if (!*link)
+				return false;
+
+			Node *target = *link;
+
+			if (target->left && target->right)
+			{
+				// Node has 2 children, find successor (minimum of right subtree).
+				Node **successor = &target->right;
+
+				path.push_back(link);
+				while ((*successor)->left)
+				{
+					path.push_back(successor);
+					successor = &(*successor)->left;
+				}
+
+				target->data = (*successor)->data;
+				target = *successor;
+				*successor = target->right;
+			}
+			else
+				*link = target->left ? target->left : target->right; // Replace with only (or no) child.
+
+			pool.release(target); // Return node to pool.
+			retrace();
+			return true;
+		}
+
+		// Check every node is balanced, using cached heights.
+		static bool isBalanced(const Node *node)
+		{
+			Vector<const Node*> stack;
+
+			if (node)
+				stack.push_back(node);
+
+			while (stack.size())
+			{
+				node = stack.back();
+				stack.pop_back();
+
+				if (abs(Node::height(node->left) - Node::height(node->right)) > 1)
+					return false;
+				if (node->left)
+					stack.push_back(node->left);
+				if (node->right)
+					stack.push_back(node->right);
+			}
+
+			return true;
+		}
+		
+
+		// Merge sorted items [first, first + count) with the in-order nodes of
+		// tree, and link all into a balanced tree. Returns items inserted.
+		template <class It>
+		std::size_t mergeSorted(It first, std::size_t count, bool unique)
+		{
+			Vector<Node*> existing, nodes;
+			std::size_t i = 0, added = 0;
+
+			existing.reserve(size());
+			makeArray(root, existing);
+			nodes.reserve(existing.size() + count);
+			for (; count; count--, ++first)
+			{
+				// Equal items go right of (after) tree items.
+				while (i < existing.size() && !(*first < existing[i]->data))
+					nodes.push_back(existing[i++]);
+				if (unique && nodes.size() && nodes.back()->data == *first)
+					continue;
+				nodes.push_back(pool.allocate(Node(*first)));
+				added++;
+			}
+			while (i < existing.size())
+				nodes.push_back(existing[i++]);
+
+			root = buildTree(nodes, 0, nodes.size());
+			return added;
+		}
+
+		// Links (sorted) array of nodes [start, end) into a balanced subtree, 
+		// returns its root.
+		static Node* buildTree(Vector<Node*>& nodes, std::size_t start, std::size_t end)
+		{
+			if (start == end)
+				return nullptr;
+
+			std::size_t mid = start + (end - start) / 2;
+			Node *node = nodes[mid];
+
+			node->left = buildTree(nodes, start, mid);
+			node->right = buildTree(nodes, mid + 1, end);
+			node->updateHeight();
+			return node;
+		}
+
+		// Constructs sorted array of tree nodes via iterative inOrder traversal.
+		static void makeArray(Node *node, Vector<Node*>& nodes)
+		{
+			Vector<Node*> stack;
+
+			while (node || stack.size())
+			{
+				while (node)
+				{
+					stack.push_back(node);
+					node = node->left;
+				}
+
+				node = stack.back();
+				stack.pop_back();
+				nodes.push_back(node);
+				node = node->right;
+			}
+		}
+
+#ifdef BALANCE_TREE
+		// Attempt to reconstruct tree as balanced. Existing nodes are relinked, 
+		// so no data is copied.
+		void balanceTree(Node *node)
+		{
+			// Store nodes in sorted order.
+			Vector<Node*> nodes;
+			nodes.reserve(size());
+			makeArray(node, nodes);
+			// Reconstruct a balanced tree.
+			root = buildTree(nodes, 0, nodes.size());
+		}
+#endif // End BALANCE_TREE.
+	};
+}
+
+#endif
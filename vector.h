@@ -1,109 +1,239 @@
-/*************************************************************************
-* Title: Vector
-* File: vector.h
-* Author: James Eli
-* Date: 10/26/2018
-*
-* Vector class using smart pointers with basic functionality. Resizes by
-* doubling capacity, but never down sizes.
-*
-* Notes:
-*  (1) NOT bounds checked.
-*  (2) Compiled/tested with MS Visual Studio 2017 Community (v141), and
-*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
-*  (3) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
-*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
-*
-* Submitted in partial fulfillment of the requirements of PCC CIS-269.
-*************************************************************************
-* Change Log:
-*  10/26/2018: Initial release. JME
-*  11/06/2018: Corrected copy ctor. JME
-*************************************************************************/
-#ifndef _MY_VECTOR_H_
-#define _MY_VECTOR_H_
-
-#include <memory> // shared/unique pointer
-
-namespace myVector
-{
-	template<typename T>
-	class Vector
-	{
-		std::size_t count;         // Number of actually stored objects.
-		std::size_t capacity;      // Allocated capacity.
-		std::shared_ptr<T[]> data; // Data element.
-
-	public:
-		// Default ctor.
-		Vector() : count(0), capacity(0), data(nullptr) { };
-		// Copy ctor.
-		Vector(Vector const &rhs) : count(rhs.count), capacity(rhs.capacity)
-		{
-			std::unique_ptr<T[]> newData = std::make_unique<T[]>(count);
-			for (std::size_t i = 0; i < count; i++)
-				newData[i] = rhs.data[i];
-			data.reset(newData.release());
-		};
-		// Move ctor.
-		Vector(Vector const &&rhs)
-		{
-			count = rhs.count;
-			capacity = rhs.capacity;
-			data = std::move(rhs.data);
-		};
-
-		// Dtor.
-		~Vector() { clear(); };
-
-		// Clear.
-		void clear() { data.reset(); };
-
-		// Assignment operator.
-		Vector &operator= (Vector const &rhs)
-		{
-			count = rhs.count;
-			capacity = rhs.capacity;
-			std::unique_ptr<T[]> temp(static_cast<T*>(data.release()));
-			data.reset(new T[capacity]);
-			for (std::size_t i = 0; i < count; i++)
-				data[i] = temp[i];
-			return *this;
-		};
-
-		// Adds new value, and if needed allocates more space.
-		void push_back(T const &d)
-		{
-			if (capacity == count)
-				resize();
-			data[count++] = d;
-		};
-
-		// Removes value.
-		void pop_back()
-		{
-			if (count == 0)
-				return;
-			count--;
-		};
-
-		// Size getter.
-		std::size_t size() const { return count; };
-
-		// Bracketed set/get.
-		T const &operator[] (std::size_t i) const { return data[i]; };
-		T &operator[] (std::size_t i) { return data[i]; };
-
-	private:
-		// Allocates double the old space.
-		void resize()
-		{
-			capacity = capacity ? capacity * 2 : 1;
-			std::unique_ptr<T[]> newData = std::make_unique<T[]>(capacity);
-			for (std::size_t i = 0; i < count; i++)
-				newData[i] = data[i];
-			data.reset(newData.release());
-		};
-	};
-}
-#endif
+/*************************************************************************
+* Title: Vector
+* File: vector.h
+* Author: James Eli
+* Date: 10/26/2018
+*
+* Vector class with basic functionality. Resizes by doubling capacity, but
+* never down sizes. Elements are moved (not copied) to the new storage,
+* and trivially copyable elements are moved with a single memcpy.
+*
+*   reserve(n)         // allocate space for n elements.
+*   push_back(val)     // copy or move value to end.
+*   emplace_back(args) // construct value in place at end.
+*   begin(), end()     // iterators (pointers).
+*
+* Notes:
+*  (1) NOT bounds checked.
+*  (2) Storage comes from the Allocator template parameter (std::allocator
+*      by default), only the space for stored elements is constructed.
+*  (3) clear() destroys elements but keeps storage for reuse.
+*  (4) Compiled/tested with MS Visual Studio 2017 Community (v141), and
+*      Windows SDK version 10.0.17134.0 (32 & 64-bit).
+*  (5) Compiled/tested with Eclipse Oxygen.3a Release (4.7.3a), using
+*      CDT 9.4.3 and MinGw32 gcc-g++ (6.3.0-1).
+*
+* Submitted in partial fulfillment of the requirements of PCC CIS-269.
+*************************************************************************
+* Change Log:
+*  10/26/2018: Initial release. JME
+*  11/06/2018: Corrected copy ctor. JME
+*  10/16/2026: clear() resets count and capacity. JME
+*  10/17/2026: Allocator parameter, move semantics, reserve, emplace_back
+*              and iterators. Grow moves elements. clear() keeps storage.
+*              JME
+*************************************************************************/
+#ifndef _MY_VECTOR_H_
+#define _MY_VECTOR_H_
+
+#include <cstring>     // memcpy
+#include <memory>      // allocator
+#include <type_traits> // trivially copyable
+#include <utility>     // move, forward, swap
+
+namespace myVector
+{
+	template<typename T, typename Allocator = std::allocator<T>>
+	class Vector
+	{
+		typedef std::allocator_traits<Allocator> Traits;
+
+		Allocator alloc;      // Storage allocator.
+		T* data;              // Data elements.
+		std::size_t count;    // Number of actually stored objects.
+		std::size_t capacity; // Allocated capacity.
+
+	public:
+		typedef T value_type;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+
+		// Default ctor.
+		Vector() : alloc(), data(nullptr), count(0), capacity(0) { };
+		explicit Vector(const Allocator& a) : alloc(a), data(nullptr), count(0), capacity(0) { };
+		// Copy ctor.
+		Vector(Vector const &rhs) : alloc(Traits::select_on_container_copy_construction(rhs.alloc)), data(nullptr), count(0), capacity(0)
+		{
+			reserve(rhs.count);
+			for (std::size_t i = 0; i < rhs.count; i++)
+				Traits::construct(alloc, data + i, rhs.data[i]);
+			count = rhs.count;
+		};
+		// Move ctor.
+		Vector(Vector &&rhs) noexcept : alloc(std::move(rhs.alloc)), data(rhs.data), count(rhs.count), capacity(rhs.capacity)
+		{
+			rhs.data = nullptr;
+			rhs.count = rhs.capacity = 0;
+		};
+
+		// Dtor.
+		~Vector()
+		{
+			clear();
+			if (data)
+				Traits::deallocate(alloc, data, capacity);
+		};
+
+		// Destroy all elements, keeps storage.
+		void clear()
+		{
+			while (count)
+				Traits::destroy(alloc, data + --count);
+		};
+
+		// Assignment operators.
+		Vector &operator= (Vector const &rhs)
+		{
+			if (this != &rhs)
+			{
+				Vector tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		};
+		Vector &operator= (Vector &&rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				Vector tmp(std::move(rhs));
+				swap(tmp);
+			}
+			return *this;
+		};
+
+		void swap(Vector &rhs) noexcept
+		{
+			using std::swap;
+			swap(alloc, rhs.alloc);
+			swap(data, rhs.data);
+			swap(count, rhs.count);
+			swap(capacity, rhs.capacity);
+		}
+
+		// Ensure space for n elements.
+		void reserve(std::size_t n)
+		{
+			if (n > capacity)
+				relocate(n);
+		};
+
+		// Adds new value, and if needed allocates more space.
+		void push_back(T const &d) { emplace_back(d); };
+		void push_back(T &&d) { emplace_back(std::move(d)); };
+
+		// Construct new value in place.
+		template <class... Args>
+		T &emplace_back(Args&&... args)
+		{
+			if (capacity == count)
+			{
+				// Construct new value before moving old ones, args may refer to an element.
+				std::size_t newCapacity = capacity ? capacity * 2 : 1;
+				T* newData = Traits::allocate(alloc, newCapacity);
+
+				try { Traits::construct(alloc, newData + count, std::forward<Args>(args)...); }
+				catch (...)
+				{
+					Traits::deallocate(alloc, newData, newCapacity);
+					throw;
+				}
+				try { moveTo(newData, newCapacity); }
+				catch (...)
+				{
+					Traits::destroy(alloc, newData + count);
+					Traits::deallocate(alloc, newData, newCapacity);
+					throw;
+				}
+			}
+			else
+				Traits::construct(alloc, data + count, std::forward<Args>(args)...);
+
+			return data[count++];
+		};
+
+		// Removes value.
+		void pop_back()
+		{
+			if (count == 0)
+				return;
+			Traits::destroy(alloc, data + --count);
+		};
+
+		// Size getters.
+		std::size_t size() const { return count; };
+		bool empty() const { return count == 0; };
+
+		// Bracketed set/get.
+		T const &operator[] (std::size_t i) const { return data[i]; };
+		T &operator[] (std::size_t i) { return data[i]; };
+
+		T &back() { return data[count - 1]; };
+		T const &back() const { return data[count - 1]; };
+
+		// Iterators.
+		iterator begin() { return data; };
+		iterator end() { return data + count; };
+		const_iterator begin() const { return data; };
+		const_iterator end() const { return data + count; };
+
+	private:
+		// Move elements to new storage of n elements.
+		void relocate(std::size_t n)
+		{
+			T* newData = Traits::allocate(alloc, n);
+
+			try { moveTo(newData, n); }
+			catch (...)
+			{
+				Traits::deallocate(alloc, newData, n);
+				throw;
+			}
+		};
+
+		// Move elements into (allocated) newData, and release old storage. If
+		// an element copy throws, the vector is unchanged.
+		void moveTo(T* newData, std::size_t newCapacity)
+		{
+			if (std::is_trivially_copyable<T>::value)
+			{
+				if (count)
+					std::memcpy(static_cast<void*>(newData), static_cast<const void*>(data), count * sizeof(T));
+			}
+			else
+			{
+				std::size_t i = 0;
+
+				// Copies instead if move could throw.
+				try
+				{
+					for (; i < count; i++)
+						Traits::construct(alloc, newData + i, std::move_if_noexcept(data[i]));
+				}
+				catch (...)
+				{
+					while (i)
+						Traits::destroy(alloc, newData + --i);
+					throw;
+				}
+				for (i = 0; i < count; i++)
+					Traits::destroy(alloc, data + i);
+			}
+
+			if (data)
+				Traits::deallocate(alloc, data, capacity);
+			data = newData;
+			capacity = newCapacity;
+		};
+	};
+}
+#endif